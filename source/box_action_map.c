@@ -0,0 +1,244 @@
+#include "box_action_map.h"
+
+#include "toy_memory.h"
+#include "toy_console_colors.h"
+
+#include <stdio.h>
+
+//utils
+static void setActionUtil(Box_ActionMap* map, int action, float value) {
+	Uint64 bit = (Uint64)1 << action;
+	bool held = value > 0.0f;
+
+	if (held && !(map->held & bit)) {
+		map->pressed |= bit;
+	}
+	else if (!held && (map->held & bit)) {
+		map->released |= bit;
+	}
+
+	map->held = held ? (map->held | bit) : (map->held & ~bit);
+	map->values[action] = value;
+}
+
+//an action is as strong as its strongest binding
+static void updateActionUtil(Box_ActionMap* map, int action) {
+	float value = 0.0f;
+
+	for (int i = 0; i < map->bindingCount; i++) {
+		if (map->bindings[i].action == action && map->bindings[i].value > value) {
+			value = map->bindings[i].value;
+		}
+	}
+
+	setActionUtil(map, action, value);
+}
+
+//feed one input to every binding which uses it
+static void inputUtil(Box_ActionMap* map, Box_ActionSource source, int code, float value) {
+	for (int i = 0; i < map->bindingCount; i++) {
+		Box_ActionBinding* binding = &map->bindings[i];
+
+		if (binding->source != source || binding->code != code) {
+			continue;
+		}
+
+		//axes only count in the bound direction
+		binding->value = source == BOX_ACTION_SOURCE_GAMEPAD_AXIS ? (value * binding->direction > 0.0f ? value * binding->direction : 0.0f) : value;
+
+		updateActionUtil(map, binding->action);
+	}
+}
+
+static float axisUtil(Box_ActionMap* map, Sint16 raw) {
+	float value = raw / 32767.0f;
+	float magnitude = value < 0.0f ? -value : value;
+
+	if (magnitude <= map->deadzone) {
+		return 0.0f;
+	}
+
+	//rescale, so the edge of the deadzone reads as 0
+	magnitude = (magnitude - map->deadzone) / (1.0f - map->deadzone);
+
+	if (magnitude > 1.0f) {
+		magnitude = 1.0f;
+	}
+
+	return value < 0.0f ? -magnitude : magnitude;
+}
+
+//exposed functions
+void Box_initActionMap(Box_ActionMap* map) {
+	Toy_initLiteralDictionary(&map->names);
+	map->count = 0;
+	map->bindings = NULL;
+	map->capacity = 0;
+	map->bindingCount = 0;
+	map->held = 0;
+	map->pressed = 0;
+	map->released = 0;
+	map->deadzone = BOX_DEFAULT_AXIS_DEADZONE;
+	map->gamepads = NULL;
+	map->gamepadCapacity = 0;
+	map->gamepadCount = 0;
+
+	for (int i = 0; i < BOX_MAX_ACTIONS; i++) {
+		map->values[i] = 0.0f;
+	}
+}
+
+void Box_freeActionMap(Box_ActionMap* map) {
+	for (int i = 0; i < map->gamepadCount; i++) {
+		SDL_GameControllerClose(map->gamepads[i]);
+	}
+
+	TOY_FREE_ARRAY(SDL_GameController*, map->gamepads, map->gamepadCapacity);
+	TOY_FREE_ARRAY(Box_ActionBinding, map->bindings, map->capacity);
+	Toy_freeLiteralDictionary(&map->names);
+
+	map->gamepads = NULL;
+	map->gamepadCapacity = 0;
+	map->gamepadCount = 0;
+	map->bindings = NULL;
+	map->capacity = 0;
+	map->bindingCount = 0;
+}
+
+int Box_findActionMap(Box_ActionMap* map, Toy_Literal nameLiteral, bool create) {
+	if (Toy_existsLiteralDictionary(&map->names, nameLiteral)) {
+		Toy_Literal indexLiteral = Toy_getLiteralDictionary(&map->names, nameLiteral);
+		int index = TOY_AS_INTEGER(indexLiteral);
+		Toy_freeLiteral(indexLiteral);
+
+		return index;
+	}
+
+	if (!create || map->count >= BOX_MAX_ACTIONS) {
+		return -1;
+	}
+
+	Toy_Literal indexLiteral = TOY_TO_INTEGER_LITERAL(map->count);
+	Toy_setLiteralDictionary(&map->names, nameLiteral, indexLiteral);
+
+	return map->count++;
+}
+
+void Box_bindActionMap(Box_ActionMap* map, int action, Box_ActionSource source, int code, int direction) {
+	if (map->bindingCount + 1 > map->capacity) {
+		int oldCapacity = map->capacity;
+
+		map->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		map->bindings = TOY_GROW_ARRAY(Box_ActionBinding, map->bindings, oldCapacity, map->capacity);
+	}
+
+	Box_ActionBinding* binding = &map->bindings[map->bindingCount++];
+
+	binding->source = source;
+	binding->code = code;
+	binding->direction = direction < 0 ? -1 : 1;
+	binding->action = action;
+	binding->value = 0.0f;
+}
+
+void Box_unbindActionMap(Box_ActionMap* map, int action) {
+	int count = 0;
+
+	for (int i = 0; i < map->bindingCount; i++) {
+		if (map->bindings[i].action != action) {
+			map->bindings[count++] = map->bindings[i];
+		}
+	}
+
+	map->bindingCount = count;
+
+	setActionUtil(map, action, 0.0f);
+}
+
+void Box_startFrameActionMap(Box_ActionMap* map) {
+	map->pressed = 0;
+	map->released = 0;
+}
+
+void Box_handleEventActionMap(Box_ActionMap* map, SDL_Event* event) {
+	switch(event->type) {
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+			//bugfix: ignore repeat messages
+			if (!event->key.repeat) {
+				inputUtil(map, BOX_ACTION_SOURCE_KEY, (int)event->key.keysym.sym, event->type == SDL_KEYDOWN ? 1.0f : 0.0f);
+			}
+			break;
+
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP:
+			inputUtil(map, BOX_ACTION_SOURCE_MOUSE_BUTTON, (int)event->button.button, event->type == SDL_MOUSEBUTTONDOWN ? 1.0f : 0.0f);
+			break;
+
+		case SDL_CONTROLLERBUTTONDOWN:
+		case SDL_CONTROLLERBUTTONUP:
+			inputUtil(map, BOX_ACTION_SOURCE_GAMEPAD_BUTTON, (int)event->cbutton.button, event->type == SDL_CONTROLLERBUTTONDOWN ? 1.0f : 0.0f);
+			break;
+
+		case SDL_CONTROLLERAXISMOTION:
+			inputUtil(map, BOX_ACTION_SOURCE_GAMEPAD_AXIS, (int)event->caxis.axis, axisUtil(map, event->caxis.value));
+			break;
+
+		//also sent for the gamepads already connected at startup
+		case SDL_CONTROLLERDEVICEADDED: {
+			SDL_GameController* gamepad = SDL_GameControllerOpen(event->cdevice.which);
+
+			if (gamepad == NULL) {
+				fprintf(stderr, TOY_CC_ERROR "Could not open a gamepad: %s\n" TOY_CC_RESET, SDL_GetError());
+				break;
+			}
+
+			if (map->gamepadCount + 1 > map->gamepadCapacity) {
+				int oldCapacity = map->gamepadCapacity;
+
+				map->gamepadCapacity = TOY_GROW_CAPACITY(oldCapacity);
+				map->gamepads = TOY_GROW_ARRAY(SDL_GameController*, map->gamepads, oldCapacity, map->gamepadCapacity);
+			}
+
+			map->gamepads[map->gamepadCount++] = gamepad;
+		}
+		break;
+
+		case SDL_CONTROLLERDEVICEREMOVED: {
+			SDL_GameController* gamepad = SDL_GameControllerFromInstanceID(event->cdevice.which);
+
+			for (int i = 0; i < map->gamepadCount; i++) {
+				if (map->gamepads[i] == gamepad) {
+					SDL_GameControllerClose(gamepad);
+					map->gamepads[i] = map->gamepads[--map->gamepadCount];
+					break;
+				}
+			}
+
+			//don't leave anything held down by the missing gamepad
+			for (int i = 0; i < map->bindingCount; i++) {
+				if (map->bindings[i].source == BOX_ACTION_SOURCE_GAMEPAD_BUTTON || map->bindings[i].source == BOX_ACTION_SOURCE_GAMEPAD_AXIS) {
+					map->bindings[i].value = 0.0f;
+					updateActionUtil(map, map->bindings[i].action);
+				}
+			}
+		}
+		break;
+	}
+}
+
+bool Box_isHeldActionMap(Box_ActionMap* map, int action) {
+	return (map->held >> action) & 1;
+}
+
+bool Box_isPressedActionMap(Box_ActionMap* map, int action) {
+	return (map->pressed >> action) & 1;
+}
+
+bool Box_isReleasedActionMap(Box_ActionMap* map, int action) {
+	return (map->released >> action) & 1;
+}
+
+float Box_getValueActionMap(Box_ActionMap* map, int action) {
+	return map->values[action];
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "box_common.h"
+
+#include "toy_literal.h"
+#include "toy_literal_dictionary.h"
+
+//each action is one bit in the state sets
+#define BOX_MAX_ACTIONS 64
+
+//analog input below this is ignored
+#define BOX_DEFAULT_AXIS_DEADZONE 0.2f
+
+//the inputs an action can be bound to
+typedef enum Box_ActionSource {
+	BOX_ACTION_SOURCE_KEY, //by keycode
+	BOX_ACTION_SOURCE_MOUSE_BUTTON,
+	BOX_ACTION_SOURCE_GAMEPAD_BUTTON, //on any gamepad
+	BOX_ACTION_SOURCE_GAMEPAD_AXIS,
+} Box_ActionSource;
+
+//one input driving one action - an action can have many, and an input can drive many actions
+typedef struct Box_private_action_binding {
+	Box_ActionSource source;
+	int code; //keycode, mouse button, gamepad button or axis
+	int direction; //for axes, 1 or -1
+	int action;
+	float value; //from 0 to 1
+} Box_ActionBinding;
+
+//the state of every action, updated from SDL's events and polled by scripts
+typedef struct Box_private_action_map {
+	Toy_LiteralDictionary names; //action name -> index
+	int count;
+
+	Box_ActionBinding* bindings;
+	int capacity;
+	int bindingCount;
+
+	//one bit per action
+	Uint64 held;
+	Uint64 pressed; //since the start of the frame
+	Uint64 released; //since the start of the frame
+	float values[BOX_MAX_ACTIONS]; //the strongest binding of each action
+
+	float deadzone;
+
+	//open gamepads
+	SDL_GameController** gamepads;
+	int gamepadCapacity;
+	int gamepadCount;
+} Box_ActionMap;
+
+BOX_API void Box_initActionMap(Box_ActionMap* map);
+BOX_API void Box_freeActionMap(Box_ActionMap* map);
+
+//returns the action's index, or -1 if there's no such action (or no room for it, when creating)
+BOX_API int Box_findActionMap(Box_ActionMap* map, Toy_Literal nameLiteral, bool create);
+
+BOX_API void Box_bindActionMap(Box_ActionMap* map, int action, Box_ActionSource source, int code, int direction);
+BOX_API void Box_unbindActionMap(Box_ActionMap* map, int action); //removes every binding of the action
+
+BOX_API void Box_startFrameActionMap(Box_ActionMap* map); //clears pressed and released, call before polling events
+BOX_API void Box_handleEventActionMap(Box_ActionMap* map, SDL_Event* event);
+
+//O(1) queries - a tap within one frame is both pressed and released, but never held
+BOX_API bool Box_isHeldActionMap(Box_ActionMap* map, int action);
+BOX_API bool Box_isPressedActionMap(Box_ActionMap* map, int action);
+BOX_API bool Box_isReleasedActionMap(Box_ActionMap* map, int action);
+BOX_API float Box_getValueActionMap(Box_ActionMap* map, int action);
@@ -0,0 +1,339 @@
+#include "box_asset_loader.h"
+#include "box_engine.h"
+#include "box_pack.h"
+
+#include "toy_memory.h"
+#include "toy_console_colors.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//utils
+static void freeDecodedUtil(Box_Asset* asset) {
+	if (asset->surface != NULL) {
+		SDL_FreeSurface(asset->surface);
+		asset->surface = NULL;
+	}
+
+	if (asset->chunk != NULL) {
+		Mix_FreeChunk(asset->chunk);
+		asset->chunk = NULL;
+	}
+
+	if (asset->music != NULL) {
+		Mix_FreeMusic(asset->music);
+		asset->music = NULL;
+	}
+}
+
+static void freeAssetUtil(Box_Asset* asset) {
+	freeDecodedUtil(asset);
+
+	if (asset->textureEntry != NULL) {
+		Box_releaseTextureCache(&engine.textureCache, asset->textureEntry);
+	}
+
+	Toy_freeLiteral(asset->callback);
+	TOY_FREE_ARRAY(char, asset->path, strlen(asset->path) + 1);
+	TOY_FREE(Box_Asset, asset);
+}
+
+static int workerThreadUtil(void* data) {
+	Box_AssetLoader* loader = (Box_AssetLoader*)data;
+
+	SDL_LockMutex(loader->mutex);
+
+	while (true) {
+		while (!loader->quit && loader->queueNext >= loader->queueCount) {
+			SDL_CondWait(loader->wake, loader->mutex);
+		}
+
+		if (loader->quit) {
+			break;
+		}
+
+		//path and kind never change, so the asset can be read without the lock
+		Box_Asset* asset = loader->queue[loader->queueNext++];
+
+		if (loader->queueNext >= loader->queueCount) {
+			loader->queueNext = 0;
+			loader->queueCount = 0;
+		}
+
+		SDL_UnlockMutex(loader->mutex);
+
+		SDL_Surface* surface = NULL;
+		Mix_Chunk* chunk = NULL;
+		Mix_Music* music = NULL;
+
+		switch(asset->kind) {
+			case BOX_ASSET_TEXTURE:
+				surface = IMG_Load_RW(Box_openRWPack(asset->path), 1);
+				break;
+
+			case BOX_ASSET_SOUND:
+				chunk = Mix_LoadWAV_RW(Box_openRWPack(asset->path), 1);
+				break;
+
+			case BOX_ASSET_MUSIC:
+				music = Mix_LoadMUS_RW(Box_openRWPack(asset->path), 1);
+				break;
+		}
+
+		SDL_LockMutex(loader->mutex);
+
+		asset->surface = surface;
+		asset->chunk = chunk;
+		asset->music = music;
+		asset->decoded = true;
+	}
+
+	SDL_UnlockMutex(loader->mutex);
+
+	return 0;
+}
+
+static void startThreadsUtil(Box_AssetLoader* loader) {
+	//leave a core for the main thread
+	int count = SDL_GetCPUCount() - 1;
+
+	if (count < 1) {
+		count = 1;
+	}
+
+	if (count > BOX_ASSET_LOADER_MAX_THREADS) {
+		count = BOX_ASSET_LOADER_MAX_THREADS;
+	}
+
+	for (int i = 0; i < count; i++) {
+		SDL_Thread* thread = SDL_CreateThread(workerThreadUtil, "Box_AssetLoader", loader);
+
+		if (thread == NULL) {
+			fprintf(stderr, TOY_CC_ERROR "Could not start an asset loader thread: %s\n" TOY_CC_RESET, SDL_GetError());
+			break;
+		}
+
+		loader->threads[loader->threadCount++] = thread;
+	}
+}
+
+//runs on the main thread, once the asset is decoded
+static bool finishAssetUtil(Box_AssetLoader* loader, Box_Asset* asset, int* uploads) {
+	switch(asset->kind) {
+		case BOX_ASSET_TEXTURE: {
+			if (asset->surface == NULL) {
+				asset->state = BOX_ASSET_FAILED;
+				break;
+			}
+
+			//spread the uploads over several frames
+			if (*uploads >= loader->uploadBudget) {
+				return false;
+			}
+
+			(*uploads)++;
+
+			Toy_Literal pathLiteral = TOY_TO_STRING_LITERAL(Toy_createRefString(asset->path));
+			asset->textureEntry = Box_storeSurfaceTextureCache(&engine.textureCache, engine.renderer, pathLiteral, asset->surface);
+			Toy_freeLiteral(pathLiteral);
+
+			SDL_FreeSurface(asset->surface);
+			asset->surface = NULL;
+
+			asset->state = asset->textureEntry != NULL ? BOX_ASSET_READY : BOX_ASSET_FAILED;
+		}
+		break;
+
+		case BOX_ASSET_SOUND:
+			asset->state = asset->chunk != NULL ? BOX_ASSET_READY : BOX_ASSET_FAILED;
+			break;
+
+		case BOX_ASSET_MUSIC:
+			if (asset->music == NULL) {
+				asset->state = BOX_ASSET_FAILED;
+				break;
+			}
+
+			//like loadMusic(), but the old music plays until now
+			if (engine.music != NULL) {
+				Mix_FreeMusic(engine.music);
+			}
+
+			engine.music = asset->music;
+			asset->music = NULL;
+			asset->state = BOX_ASSET_READY;
+			break;
+	}
+
+	if (asset->state == BOX_ASSET_FAILED) {
+		fprintf(stderr, TOY_CC_ERROR "Could not load the asset \"%s\"\n" TOY_CC_RESET, asset->path);
+	}
+
+	return true;
+}
+
+//exposed functions
+void Box_initAssetLoader(Box_AssetLoader* loader) {
+	loader->threadCount = 0;
+	loader->mutex = SDL_CreateMutex();
+	loader->wake = SDL_CreateCond();
+	loader->quit = false;
+
+	loader->queue = NULL;
+	loader->queueCapacity = 0;
+	loader->queueCount = 0;
+	loader->queueNext = 0;
+
+	loader->assets = NULL;
+	loader->capacity = 0;
+	loader->count = 0;
+
+	loader->uploadBudget = BOX_DEFAULT_ASSET_UPLOAD_BUDGET;
+}
+
+void Box_freeAssetLoader(Box_AssetLoader* loader) {
+	//let the workers finish what they're decoding
+	SDL_LockMutex(loader->mutex);
+	loader->quit = true;
+	SDL_CondBroadcast(loader->wake);
+	SDL_UnlockMutex(loader->mutex);
+
+	for (int i = 0; i < loader->threadCount; i++) {
+		SDL_WaitThread(loader->threads[i], NULL);
+	}
+
+	loader->threadCount = 0;
+
+	for (int i = 0; i < loader->count; i++) {
+		freeAssetUtil(loader->assets[i]);
+	}
+
+	TOY_FREE_ARRAY(Box_Asset*, loader->queue, loader->queueCapacity);
+	TOY_FREE_ARRAY(Box_Asset*, loader->assets, loader->capacity);
+
+	SDL_DestroyCond(loader->wake);
+	SDL_DestroyMutex(loader->mutex);
+
+	loader->queue = NULL;
+	loader->queueCapacity = 0;
+	loader->queueCount = 0;
+	loader->queueNext = 0;
+	loader->assets = NULL;
+	loader->capacity = 0;
+	loader->count = 0;
+}
+
+Box_Asset* Box_requestAssetLoader(Box_AssetLoader* loader, Box_AssetKind kind, Toy_Literal filePathLiteral, Toy_Literal callback) {
+	if (loader->threadCount == 0) {
+		startThreadsUtil(loader);
+	}
+
+	const char* filePath = Toy_toCString(TOY_AS_STRING(filePathLiteral));
+	size_t length = strlen(filePath);
+
+	Box_Asset* asset = TOY_ALLOCATE(Box_Asset, 1);
+
+	asset->kind = kind;
+	asset->state = BOX_ASSET_LOADING;
+	asset->path = TOY_ALLOCATE(char, length + 1);
+	memcpy(asset->path, filePath, length + 1);
+	asset->callback = Toy_copyLiteral(callback);
+	asset->surface = NULL;
+	asset->chunk = NULL;
+	asset->music = NULL;
+	asset->decoded = false;
+	asset->textureEntry = NULL;
+	asset->released = false;
+
+	if (loader->count + 1 > loader->capacity) {
+		int oldCapacity = loader->capacity;
+
+		loader->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		loader->assets = TOY_GROW_ARRAY(Box_Asset*, loader->assets, oldCapacity, loader->capacity);
+	}
+
+	loader->assets[loader->count++] = asset;
+
+	//without any workers, it's decoded by Box_pumpAssetLoader() instead
+	if (loader->threadCount == 0) {
+		return asset;
+	}
+
+	SDL_LockMutex(loader->mutex);
+
+	if (loader->queueCount + 1 > loader->queueCapacity) {
+		int oldCapacity = loader->queueCapacity;
+
+		loader->queueCapacity = TOY_GROW_CAPACITY(oldCapacity);
+		loader->queue = TOY_GROW_ARRAY(Box_Asset*, loader->queue, oldCapacity, loader->queueCapacity);
+	}
+
+	loader->queue[loader->queueCount++] = asset;
+
+	SDL_CondSignal(loader->wake);
+	SDL_UnlockMutex(loader->mutex);
+
+	return asset;
+}
+
+void Box_releaseAssetLoader(Box_AssetLoader* loader, Box_Asset* asset) {
+	asset->released = true;
+}
+
+void Box_pumpAssetLoader(Box_AssetLoader* loader, Toy_Interpreter* interpreter) {
+	int uploads = 0;
+
+	for (int i = 0; i < loader->count; i++) {
+		Box_Asset* asset = loader->assets[i];
+
+		bool decoded;
+
+		if (loader->threadCount > 0) {
+			SDL_LockMutex(loader->mutex);
+			decoded = asset->decoded;
+			SDL_UnlockMutex(loader->mutex);
+		}
+		else if (!asset->decoded) {
+			//no workers, so decode it here
+			switch(asset->kind) {
+				case BOX_ASSET_TEXTURE: asset->surface = IMG_Load_RW(Box_openRWPack(asset->path), 1); break;
+				case BOX_ASSET_SOUND: asset->chunk = Mix_LoadWAV_RW(Box_openRWPack(asset->path), 1); break;
+				case BOX_ASSET_MUSIC: asset->music = Mix_LoadMUS_RW(Box_openRWPack(asset->path), 1); break;
+			}
+
+			decoded = asset->decoded = true;
+		}
+		else {
+			decoded = true;
+		}
+
+		//reclaim the released assets (swap-remove, then look at this index again)
+		if (asset->released && decoded) {
+			freeAssetUtil(asset);
+			loader->assets[i--] = loader->assets[--loader->count];
+			continue;
+		}
+
+		if (!decoded || asset->state != BOX_ASSET_LOADING || !finishAssetUtil(loader, asset, &uploads)) {
+			continue;
+		}
+
+		//let the script know
+		if (!TOY_IS_NULL(asset->callback)) {
+			Toy_Literal assetLiteral = TOY_TO_OPAQUE_LITERAL(asset, BOX_OPAQUE_TAG_ASSET);
+
+			Toy_LiteralArray arguments;
+			Toy_initLiteralArray(&arguments);
+			Toy_pushLiteralArray(&arguments, assetLiteral);
+
+			Toy_LiteralArray returns;
+			Toy_initLiteralArray(&returns);
+
+			Toy_callLiteralFn(interpreter, asset->callback, &arguments, &returns);
+
+			Toy_freeLiteralArray(&arguments);
+			Toy_freeLiteralArray(&returns);
+			Toy_freeLiteral(assetLiteral);
+		}
+	}
+}
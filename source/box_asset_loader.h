@@ -0,0 +1,74 @@
+#pragma once
+
+#include "box_common.h"
+#include "box_texture_cache.h"
+
+#include "toy_literal.h"
+#include "toy_interpreter.h"
+
+//the handles given to scripts
+#define BOX_OPAQUE_TAG_ASSET 1004
+
+//worker threads, started by the first request
+#define BOX_ASSET_LOADER_MAX_THREADS 4
+
+//textures created per frame, unless changed
+#define BOX_DEFAULT_ASSET_UPLOAD_BUDGET 4
+
+typedef enum Box_AssetKind {
+	BOX_ASSET_TEXTURE, //kept in the engine's texture cache while the asset exists
+	BOX_ASSET_SOUND, //claimed by the script with getAssetSound()
+	BOX_ASSET_MUSIC, //replaces the engine's music once ready
+} Box_AssetKind;
+
+typedef enum Box_AssetState {
+	BOX_ASSET_LOADING,
+	BOX_ASSET_READY,
+	BOX_ASSET_FAILED,
+} Box_AssetState;
+
+//a file being decoded by a worker, then finished by the main thread
+typedef struct Box_private_asset {
+	Box_AssetKind kind;
+	Box_AssetState state; //only changed by the main thread
+	char* path; //resolved file path
+	Toy_Literal callback; //called with this asset once it's ready or failed, or null
+
+	//written by a worker
+	SDL_Surface* surface;
+	Mix_Chunk* chunk;
+	Mix_Music* music;
+	bool decoded; //guarded by the loader's mutex
+
+	Box_TextureCacheEntry* textureEntry;
+	bool released; //freed by the script, and reclaimed once the workers are done with it
+} Box_Asset;
+
+typedef struct Box_private_asset_loader {
+	SDL_Thread* threads[BOX_ASSET_LOADER_MAX_THREADS];
+	int threadCount;
+	SDL_mutex* mutex;
+	SDL_cond* wake;
+	bool quit;
+
+	//waiting to be decoded, guarded by the mutex
+	Box_Asset** queue;
+	int queueCapacity;
+	int queueCount;
+	int queueNext;
+
+	//every asset that hasn't been reclaimed, only touched by the main thread
+	Box_Asset** assets;
+	int capacity;
+	int count;
+
+	int uploadBudget; //textures created per frame
+} Box_AssetLoader;
+
+BOX_API void Box_initAssetLoader(Box_AssetLoader* loader);
+BOX_API void Box_freeAssetLoader(Box_AssetLoader* loader); //NOTE: must be called before the texture cache and SDL_mixer are freed
+
+BOX_API Box_Asset* Box_requestAssetLoader(Box_AssetLoader* loader, Box_AssetKind kind, Toy_Literal filePathLiteral, Toy_Literal callback); //callback can be null
+BOX_API void Box_releaseAssetLoader(Box_AssetLoader* loader, Box_Asset* asset); //the handle can't be used afterwards
+
+BOX_API void Box_pumpAssetLoader(Box_AssetLoader* loader, Toy_Interpreter* interpreter); //called once per frame - uploads the decoded files, and calls the callbacks
@@ -0,0 +1,346 @@
+#include "box_bytecode_cache.h"
+#include "box_pack.h"
+
+#include "repl_tools.h"
+
+#include "toy_memory.h"
+#include "toy_console_colors.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//utils
+static unsigned char* compileFile(const char* path, size_t* size, bool copy) {
+	Box_FileView view;
+
+	if ((copy ? Box_readFileView(&view, path) : Box_openFileView(&view, path)) != 0) {
+		return NULL;
+	}
+
+	unsigned char* tb = Box_compileViewBytecodeCache(&view, path, size);
+	Box_closeFileView(&view);
+
+	return tb;
+}
+
+static Box_BytecodeCacheEntry* getEntry(Box_BytecodeCache* cache, Toy_Literal filePathLiteral) {
+	if (!Toy_existsLiteralDictionary(&cache->entries, filePathLiteral)) {
+		return NULL;
+	}
+
+	Toy_Literal entryLiteral = Toy_getLiteralDictionary(&cache->entries, filePathLiteral);
+	Box_BytecodeCacheEntry* entry = TOY_AS_OPAQUE(entryLiteral);
+	Toy_freeLiteral(entryLiteral);
+
+	return entry;
+}
+
+static Box_BytecodeCacheEntry* storeEntry(Box_BytecodeCache* cache, Box_BytecodeCacheEntry* entry, Toy_Literal filePathLiteral, unsigned char* tb, size_t size, time_t modified, long long fileSize) {
+	//create or recycle the entry
+	if (entry == NULL) {
+		entry = TOY_ALLOCATE(Box_BytecodeCacheEntry, 1);
+		entry->bytecode = NULL;
+		entry->size = 0;
+		entry->functions = NULL;
+		entry->nodes = NULL;
+		entry->nodeCapacity = 0;
+		entry->nodeCount = 0;
+
+		Toy_Literal entryLiteral = TOY_TO_OPAQUE_LITERAL(entry, BOX_OPAQUE_TAG_BYTECODE_CACHE_ENTRY);
+		Toy_setLiteralDictionary(&cache->entries, filePathLiteral, entryLiteral);
+		Toy_freeLiteral(entryLiteral);
+	}
+	else {
+		TOY_FREE_ARRAY(unsigned char, entry->bytecode, entry->size);
+
+		//nodes already loaded keep the old functions, new ones get fresh ones
+		if (entry->functions != NULL) {
+			Box_releaseFunctionTable(entry->functions);
+			entry->functions = NULL;
+		}
+	}
+
+	entry->bytecode = tb;
+	entry->size = size;
+	entry->modified = modified;
+	entry->fileSize = fileSize;
+	entry->failedModified = 0;
+	entry->failedFileSize = -1;
+
+	if (cache->watcher != NULL) {
+		Box_watchFileWatcher(cache->watcher, Toy_toCString(TOY_AS_STRING(filePathLiteral)));
+	}
+
+	return entry;
+}
+
+static void freeEntry(Box_BytecodeCacheEntry* entry) {
+	if (entry->bytecode != NULL) {
+		TOY_FREE_ARRAY(unsigned char, entry->bytecode, entry->size);
+	}
+
+	if (entry->functions != NULL) {
+		Box_releaseFunctionTable(entry->functions);
+	}
+
+	//don't leave any dangling pointers behind
+	for (int i = 0; i < entry->nodeCount; i++) {
+		entry->nodes[i]->script = NULL;
+		entry->nodes[i]->scriptIndex = -1;
+	}
+
+	TOY_FREE_ARRAY(Box_Node*, entry->nodes, entry->nodeCapacity);
+	TOY_FREE(Box_BytecodeCacheEntry, entry);
+}
+
+//exposed functions
+bool Box_isPrecompiledBytecodeCache(const unsigned char* data, size_t size) {
+	//the build string follows the version, so there's at least one more byte
+	return size > 3 && data[0] == TOY_VERSION_MAJOR && data[1] == TOY_VERSION_MINOR;
+}
+
+unsigned char* Box_compileViewBytecodeCache(Box_FileView* view, const char* filePath, size_t* size) {
+	//skip the compiler entirely
+	if (Box_isPrecompiledBytecodeCache(view->data, view->size)) {
+		unsigned char* tb = TOY_ALLOCATE(unsigned char, view->size);
+		memcpy(tb, view->data, view->size);
+
+		*size = view->size;
+		return tb;
+	}
+
+#ifdef BOX_NO_COMPILER
+	fprintf(stderr, TOY_CC_ERROR "\"%s\" isn't precompiled, and this build has no compiler\n" TOY_CC_RESET, filePath);
+	return NULL;
+#else
+	//compiled straight from the mapping
+	const unsigned char* tb = Toy_compileString(Box_getStringFileView(view), size);
+
+	if (tb == NULL) {
+		fprintf(stderr, TOY_CC_ERROR "Could not compile file \"%s\"\n" TOY_CC_RESET, filePath);
+		return NULL;
+	}
+
+	return (unsigned char*)tb;
+#endif
+}
+
+void Box_initBytecodeCache(Box_BytecodeCache* cache) {
+	Toy_initLiteralDictionary(&cache->entries);
+	cache->watcher = NULL;
+	cache->hits = 0;
+	cache->misses = 0;
+	cache->reloads = 0;
+}
+
+void Box_freeBytecodeCache(Box_BytecodeCache* cache) {
+	//the entries are opaque, so free them manually
+	for (int i = 0; i < cache->entries.capacity; i++) {
+		if (TOY_IS_NULL(cache->entries.entries[i].key)) {
+			continue;
+		}
+
+		freeEntry(TOY_AS_OPAQUE(cache->entries.entries[i].value));
+	}
+
+	Toy_freeLiteralDictionary(&cache->entries);
+}
+
+unsigned char* Box_loadBytecodeCache(Box_BytecodeCache* cache, Toy_Literal filePathLiteral, size_t* size, Box_BytecodeCacheEntry** entryOut) {
+	const char* filePath = Toy_toCString(TOY_AS_STRING(filePathLiteral));
+
+	//validate against the file as it is now (a packed file only changes with its pack)
+	time_t modified = 0;
+	long long fileSize = 0;
+	if (!Box_statFilePack(filePath, &modified, &fileSize)) {
+		fprintf(stderr, TOY_CC_ERROR "Could not open file \"%s\"\n" TOY_CC_RESET, filePath);
+		return NULL;
+	}
+
+	Box_BytecodeCacheEntry* entry = getEntry(cache, filePathLiteral);
+
+	if (entry != NULL && entry->modified == modified && entry->fileSize == fileSize) {
+		cache->hits++;
+	}
+	else {
+		cache->misses++;
+
+		size_t compiledSize = 0;
+		unsigned char* tb = compileFile(filePath, &compiledSize, false);
+
+		if (tb == NULL) {
+			return NULL;
+		}
+
+		entry = storeEntry(cache, entry, filePathLiteral, tb, compiledSize, modified, fileSize);
+	}
+
+	//need a COPY of the bytecode, because the interpreter eats it
+	unsigned char* bytecodeCopy = TOY_ALLOCATE(unsigned char, entry->size);
+	memcpy(bytecodeCopy, entry->bytecode, entry->size);
+
+	*size = entry->size;
+
+	if (entryOut != NULL) {
+		*entryOut = entry;
+	}
+
+	return bytecodeCopy;
+}
+
+void Box_storeBytecodeCache(Box_BytecodeCache* cache, Toy_Literal filePathLiteral, unsigned char* tb, size_t size, time_t modified, long long fileSize) {
+	storeEntry(cache, getEntry(cache, filePathLiteral), filePathLiteral, tb, size, modified, fileSize);
+}
+
+bool Box_isFreshBytecodeCache(Box_BytecodeCache* cache, Toy_Literal filePathLiteral) {
+	Box_BytecodeCacheEntry* entry = getEntry(cache, filePathLiteral);
+
+	if (entry == NULL) {
+		return false;
+	}
+
+	time_t modified = 0;
+	long long fileSize = 0;
+	if (!Box_statFilePack(Toy_toCString(TOY_AS_STRING(filePathLiteral)), &modified, &fileSize)) {
+		return false;
+	}
+
+	return entry->modified == modified && entry->fileSize == fileSize;
+}
+
+void Box_trackNodeBytecodeCache(Box_BytecodeCacheEntry* entry, Box_Node* node) {
+	if (entry->nodeCount + 1 > entry->nodeCapacity) {
+		int oldCapacity = entry->nodeCapacity;
+
+		entry->nodeCapacity = TOY_GROW_CAPACITY(oldCapacity);
+		entry->nodes = TOY_GROW_ARRAY(Box_Node*, entry->nodes, oldCapacity, entry->nodeCapacity);
+	}
+
+	node->script = entry;
+	node->scriptIndex = entry->nodeCount;
+	entry->nodes[entry->nodeCount++] = node;
+}
+
+void Box_untrackNodeBytecodeCache(Box_Node* node) {
+	Box_BytecodeCacheEntry* entry = node->script;
+
+	//swap the last node into the gap
+	Box_Node* last = entry->nodes[--entry->nodeCount];
+	entry->nodes[node->scriptIndex] = last;
+	last->scriptIndex = node->scriptIndex;
+
+	node->script = NULL;
+	node->scriptIndex = -1;
+}
+
+void Box_setWatcherBytecodeCache(Box_BytecodeCache* cache, Box_Watcher* watcher) {
+	cache->watcher = watcher;
+
+	if (watcher == NULL) {
+		return;
+	}
+
+	for (int i = 0; i < cache->entries.capacity; i++) {
+		if (!TOY_IS_NULL(cache->entries.entries[i].key)) {
+			Box_watchFileWatcher(watcher, Toy_toCString(TOY_AS_STRING(cache->entries.entries[i].key)));
+		}
+	}
+}
+
+int Box_reloadBytecodeCache(Box_BytecodeCache* cache, Toy_Interpreter* interpreter) {
+	//find the changed scripts first, as running them could add entries
+	Toy_LiteralArray changed;
+	Toy_initLiteralArray(&changed);
+
+	for (int i = 0; i < cache->entries.capacity; i++) {
+		if (TOY_IS_NULL(cache->entries.entries[i].key)) {
+			continue;
+		}
+
+		Box_BytecodeCacheEntry* entry = TOY_AS_OPAQUE(cache->entries.entries[i].value);
+
+		//scripts without live nodes are recompiled when next loaded, as usual
+		if (entry->nodeCount == 0) {
+			continue;
+		}
+
+		time_t modified = 0;
+		long long fileSize = 0;
+		if (!Box_statFilePack(Toy_toCString(TOY_AS_STRING(cache->entries.entries[i].key)), &modified, &fileSize)) {
+			continue; //mid-save, most likely
+		}
+
+		bool compiled = entry->modified == modified && entry->fileSize == fileSize;
+		bool failed = entry->failedModified == modified && entry->failedFileSize == fileSize;
+
+		if (!compiled && !failed) {
+			Toy_pushLiteralArray(&changed, cache->entries.entries[i].key);
+		}
+	}
+
+	int reloaded = 0;
+
+	for (int i = 0; i < changed.count; i++) {
+		Toy_Literal filePathLiteral = changed.literals[i];
+		const char* filePath = Toy_toCString(TOY_AS_STRING(filePathLiteral));
+		Box_BytecodeCacheEntry* entry = getEntry(cache, filePathLiteral);
+
+		time_t modified = 0;
+		long long fileSize = 0;
+		Box_statFilePack(filePath, &modified, &fileSize);
+
+		size_t size = 0;
+		unsigned char* tb = compileFile(filePath, &size, true); //the editor may still be writing it
+
+		//keep running the old functions until the script is fixed
+		if (tb == NULL) {
+			entry->failedModified = modified;
+			entry->failedFileSize = fileSize;
+			continue;
+		}
+
+		//hold the old table until every node has moved off it
+		Box_FunctionTable* previous = entry->functions != NULL ? Box_retainFunctionTable(entry->functions) : NULL;
+
+		storeEntry(cache, entry, filePathLiteral, tb, size, modified, fileSize);
+
+		//the interpreter eats the bytecode
+		unsigned char* bytecodeCopy = TOY_ALLOCATE(unsigned char, size);
+		memcpy(bytecodeCopy, tb, size);
+
+		Toy_Scope* scope = NULL;
+		entry->functions = Box_runFunctionTable(interpreter, bytecodeCopy, size, &scope);
+
+		for (int j = 0; j < entry->nodeCount; j++) {
+			Box_swapFunctionsNode(entry->nodes[j], previous, entry->functions, scope);
+		}
+
+		Toy_popScope(scope);
+
+		if (previous != NULL) {
+			Box_releaseFunctionTable(previous);
+		}
+
+		fprintf(stderr, TOY_CC_NOTICE "Reloaded \"%s\" (%d live nodes)\n" TOY_CC_RESET, filePath, entry->nodeCount);
+
+		cache->reloads++;
+		reloaded++;
+	}
+
+	Toy_freeLiteralArray(&changed);
+
+	return reloaded;
+}
+
+int Box_getHitsBytecodeCache(Box_BytecodeCache* cache) {
+	return cache->hits;
+}
+
+int Box_getMissesBytecodeCache(Box_BytecodeCache* cache) {
+	return cache->misses;
+}
+
+int Box_getReloadsBytecodeCache(Box_BytecodeCache* cache) {
+	return cache->reloads;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "box_common.h"
+#include "box_node.h"
+#include "box_file_view.h"
+#include "box_watcher.h"
+
+#include "toy_literal.h"
+#include "toy_literal_dictionary.h"
+
+#include <time.h>
+
+//NOTE: only used internally, never exposed to scripts
+#define BOX_OPAQUE_TAG_BYTECODE_CACHE_ENTRY 1001
+
+//a compiled script, validated against the file it came from
+typedef struct Box_private_bytecode_cache_entry {
+	unsigned char* bytecode;
+	size_t size;
+
+	//the state of the file when it was compiled
+	time_t modified;
+	long long fileSize;
+
+	//shared by the nodes loaded from this bytecode (NULL until the first one is)
+	Box_FunctionTable* functions;
+
+	//the live nodes loaded from this script, so they can be hot-reloaded
+	Box_Node** nodes;
+	int nodeCapacity;
+	int nodeCount;
+
+	//the state of the file when it last failed to recompile, so a broken edit is only reported once
+	time_t failedModified;
+	long long failedFileSize;
+} Box_BytecodeCacheEntry;
+
+//compiled scripts, keyed by their resolved drive path
+typedef struct Box_private_bytecode_cache {
+	Toy_LiteralDictionary entries; //file path -> opaque entry
+	Box_Watcher* watcher; //set while hot-reloading
+
+	//statistics
+	int hits;
+	int misses;
+	int reloads;
+} Box_BytecodeCache;
+
+BOX_API void Box_initBytecodeCache(Box_BytecodeCache* cache);
+BOX_API void Box_freeBytecodeCache(Box_BytecodeCache* cache);
+
+//precompiled bytecode starts with Toy's version, which no source file can
+BOX_API bool Box_isPrecompiledBytecodeCache(const unsigned char* data, size_t size);
+
+//bytecode for the viewed file, compiled unless it's precompiled (filePath is only used for errors)
+BOX_API unsigned char* Box_compileViewBytecodeCache(Box_FileView* view, const char* filePath, size_t* size);
+
+//returns a fresh copy of the file's bytecode, which the interpreter can take ownership of, or NULL on error
+BOX_API unsigned char* Box_loadBytecodeCache(Box_BytecodeCache* cache, Toy_Literal filePathLiteral, size_t* size, Box_BytecodeCacheEntry** entryOut); //entryOut can be NULL
+
+//for scripts compiled elsewhere, such as by the loader thread - takes ownership of "tb"
+BOX_API void Box_storeBytecodeCache(Box_BytecodeCache* cache, Toy_Literal filePathLiteral, unsigned char* tb, size_t size, time_t modified, long long fileSize);
+BOX_API bool Box_isFreshBytecodeCache(Box_BytecodeCache* cache, Toy_Literal filePathLiteral); //true if the file hasn't changed since it was compiled
+
+//call after loading a node from the entry's bytecode (Box_freeNode() untracks it)
+BOX_API void Box_trackNodeBytecodeCache(Box_BytecodeCacheEntry* entry, Box_Node* node);
+BOX_API void Box_untrackNodeBytecodeCache(Box_Node* node);
+
+//hot-reloading
+BOX_API void Box_setWatcherBytecodeCache(Box_BytecodeCache* cache, Box_Watcher* watcher); //watch the folders of every script compiled so far and from now on, or NULL to stop
+BOX_API int Box_reloadBytecodeCache(Box_BytecodeCache* cache, Toy_Interpreter* interpreter); //recompile the changed scripts with live nodes, and swap their functions in place - returns how many were reloaded
+
+BOX_API int Box_getHitsBytecodeCache(Box_BytecodeCache* cache);
+BOX_API int Box_getMissesBytecodeCache(Box_BytecodeCache* cache);
+BOX_API int Box_getReloadsBytecodeCache(Box_BytecodeCache* cache);
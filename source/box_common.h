@@ -36,6 +36,8 @@
 
 #endif
 
+//define BOX_NO_COMPILER to only load precompiled scripts (see tools/precompile.c), leaving Toy's compiler out of the build
+
 //version info
 #define BOX_VERSION_MAJOR 0
 #define BOX_VERSION_MINOR 2
@@ -0,0 +1,448 @@
+#include "box_dispatch.h"
+
+#include "toy_memory.h"
+
+#include <string.h>
+
+//utils
+static void pushListUtil(Box_DispatchList* list, Box_Node* node, int hook) {
+	if (list->count + 1 > list->capacity) {
+		int oldCapacity = list->capacity;
+
+		list->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		list->nodes = TOY_GROW_ARRAY(Box_Node*, list->nodes, oldCapacity, list->capacity);
+	}
+
+	node->dispatchIndices[hook] = list->count;
+	list->nodes[list->count++] = node;
+}
+
+//tombstone the node's entry in the list, if it's there
+static void removeListUtil(Box_DispatchList* list, Box_Node* node, int hook) {
+	int index = node->dispatchIndices[hook];
+
+	if (index >= 0 && index < list->count && list->nodes[index] == node) {
+		list->nodes[index] = NULL;
+		list->tombstones++;
+	}
+
+	node->dispatchIndices[hook] = -1;
+}
+
+//drop the tombstones, keeping the order
+static void compactListUtil(Box_DispatchList* list, int hook) {
+	int count = 0;
+
+	for (int i = 0; i < list->count; i++) {
+		if (list->nodes[i] != NULL) {
+			list->nodes[i]->dispatchIndices[hook] = count;
+			list->nodes[count++] = list->nodes[i];
+		}
+	}
+
+	list->count = count;
+	list->tombstones = 0;
+}
+
+//append this node and its children, in tree order
+static void pushRecursiveUtil(Box_Dispatcher* dispatcher, Box_Node* node) {
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		if ((node->hooks & ~node->mutedHooks) & BOX_HOOK_BIT(i)) {
+			pushListUtil(&dispatcher->lists[i], node, i);
+		}
+	}
+
+	//recurse to the (non-tombstone) children
+	for (int i = 0; i < node->count; i++) {
+		if (node->children[i] != NULL) {
+			pushRecursiveUtil(dispatcher, node->children[i]);
+		}
+	}
+}
+
+static void rebuildUtil(Box_Dispatcher* dispatcher, Box_Node* root) {
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		dispatcher->lists[i].count = 0; //keep the capacity
+		dispatcher->lists[i].tombstones = 0;
+	}
+
+	if (root != NULL) {
+		pushRecursiveUtil(dispatcher, root);
+	}
+
+	dispatcher->dirty = false;
+}
+
+//bring a list up to date, between calls
+static void refreshListUtil(Box_Dispatcher* dispatcher, Box_Node* root, Box_LifecycleHook hook) {
+	if (dispatcher->callDepth > 0) {
+		return;
+	}
+
+	if (dispatcher->dirty) {
+		rebuildUtil(dispatcher, root);
+	}
+	else if (dispatcher->lists[hook].tombstones > 0) {
+		compactListUtil(&dispatcher->lists[hook], hook);
+	}
+}
+
+//is this the last live child of its parent?
+static bool isLastChildUtil(Box_Node* node) {
+	Box_Node* parent = node->parent;
+
+	for (int i = parent->count - 1; i >= 0; i--) {
+		if (parent->children[i] != NULL) {
+			return parent->children[i] == node;
+		}
+	}
+
+	return false;
+}
+
+//find or create the list for an event
+static Box_EventList* getEventListUtil(Box_Dispatcher* dispatcher, Toy_Literal eventLiteral, bool create) {
+	if (Toy_existsLiteralDictionary(&dispatcher->events, eventLiteral)) {
+		Toy_Literal indexLiteral = Toy_getLiteralDictionary(&dispatcher->events, eventLiteral);
+		Box_EventList* list = &dispatcher->eventLists[TOY_AS_INTEGER(indexLiteral)];
+		Toy_freeLiteral(indexLiteral);
+
+		return list;
+	}
+
+	if (!create) {
+		return NULL;
+	}
+
+	if (dispatcher->eventCount + 1 > dispatcher->eventCapacity) {
+		int oldCapacity = dispatcher->eventCapacity;
+
+		dispatcher->eventCapacity = TOY_GROW_CAPACITY(oldCapacity);
+		dispatcher->eventLists = TOY_GROW_ARRAY(Box_EventList, dispatcher->eventLists, oldCapacity, dispatcher->eventCapacity);
+	}
+
+	Toy_Literal indexLiteral = TOY_TO_INTEGER_LITERAL(dispatcher->eventCount);
+	Toy_setLiteralDictionary(&dispatcher->events, eventLiteral, indexLiteral);
+
+	Box_EventList* list = &dispatcher->eventLists[dispatcher->eventCount++];
+
+	list->subscriptions = NULL;
+	list->capacity = 0;
+	list->count = 0;
+	list->dirty = false;
+
+	return list;
+}
+
+static void unsubscribeUtil(Box_EventList* list, int index) {
+	Box_EventSubscription* subscription = &list->subscriptions[index];
+
+	subscription->node->subscriptionCount--;
+	subscription->node = NULL;
+	Toy_freeLiteral(subscription->fn);
+	subscription->fn = TOY_TO_NULL_LITERAL;
+
+	list->dirty = true;
+}
+
+//drop the tombstones, keeping the order
+static void compactEventListsUtil(Box_Dispatcher* dispatcher) {
+	for (int i = 0; i < dispatcher->eventCount; i++) {
+		Box_EventList* list = &dispatcher->eventLists[i];
+
+		if (!list->dirty) {
+			continue;
+		}
+
+		int count = 0;
+
+		for (int j = 0; j < list->count; j++) {
+			if (list->subscriptions[j].node != NULL) {
+				list->subscriptions[count++] = list->subscriptions[j];
+			}
+		}
+
+		list->count = count;
+		list->dirty = false;
+	}
+}
+
+//exposed functions
+void Box_initDispatcher(Box_Dispatcher* dispatcher) {
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		dispatcher->lists[i].nodes = NULL;
+		dispatcher->lists[i].capacity = 0;
+		dispatcher->lists[i].count = 0;
+		dispatcher->lists[i].tombstones = 0;
+	}
+
+	dispatcher->dirty = true;
+	dispatcher->callDepth = 0;
+
+	Toy_initLiteralDictionary(&dispatcher->events);
+	dispatcher->eventLists = NULL;
+	dispatcher->eventCapacity = 0;
+	dispatcher->eventCount = 0;
+	dispatcher->emitDepth = 0;
+
+	dispatcher->queue = NULL;
+	dispatcher->queueCapacity = 0;
+	dispatcher->queueCount = 0;
+	dispatcher->drainedCount = 0;
+	dispatcher->drainMilliseconds = 0.0f;
+}
+
+void Box_freeDispatcher(Box_Dispatcher* dispatcher) {
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		TOY_FREE_ARRAY(Box_Node*, dispatcher->lists[i].nodes, dispatcher->lists[i].capacity);
+		dispatcher->lists[i].nodes = NULL;
+		dispatcher->lists[i].capacity = 0;
+		dispatcher->lists[i].count = 0;
+	}
+
+	dispatcher->dirty = true;
+
+	for (int i = 0; i < dispatcher->eventCount; i++) {
+		Box_EventList* list = &dispatcher->eventLists[i];
+
+		for (int j = 0; j < list->count; j++) {
+			Toy_freeLiteral(list->subscriptions[j].fn);
+		}
+
+		TOY_FREE_ARRAY(Box_EventSubscription, list->subscriptions, list->capacity);
+	}
+
+	TOY_FREE_ARRAY(Box_EventList, dispatcher->eventLists, dispatcher->eventCapacity);
+	Toy_freeLiteralDictionary(&dispatcher->events);
+
+	dispatcher->eventLists = NULL;
+	dispatcher->eventCapacity = 0;
+	dispatcher->eventCount = 0;
+
+	//undelivered events are dropped
+	for (int i = 0; i < dispatcher->queueCount; i++) {
+		Toy_freeLiteral(dispatcher->queue[i].event);
+		Toy_freeLiteralArray(&dispatcher->queue[i].args);
+	}
+
+	TOY_FREE_ARRAY(Box_QueuedEvent, dispatcher->queue, dispatcher->queueCapacity);
+
+	dispatcher->queue = NULL;
+	dispatcher->queueCapacity = 0;
+	dispatcher->queueCount = 0;
+}
+
+void Box_pushDispatcher(Box_Dispatcher* dispatcher, Box_Node* root, Box_Node* parent, Box_Node* child) {
+	//a rebuild will pick this up anyway
+	if (dispatcher->dirty) {
+		return;
+	}
+
+	//the new subtree is placed after the rest of the parent's subtree, so it can be appended if nothing comes after that
+	bool last = true;
+	Box_Node* ptr = parent;
+
+	while (ptr->parent != NULL) {
+		if (last && !isLastChildUtil(ptr)) {
+			last = false;
+		}
+
+		ptr = ptr->parent;
+	}
+
+	//ignore nodes outside of the root node's tree
+	if (ptr != root) {
+		return;
+	}
+
+	if (last) {
+		pushRecursiveUtil(dispatcher, child);
+	}
+	else {
+		dispatcher->dirty = true;
+	}
+}
+
+void Box_removeDispatcher(Box_Dispatcher* dispatcher, Box_Node* node) {
+	//leave tombstones, so any iteration in progress can continue safely
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		if (node->hooks & BOX_HOOK_BIT(i)) {
+			removeListUtil(&dispatcher->lists[i], node, i); //compacted before the next call
+		}
+	}
+
+	//only nodes with subscriptions need the custom events searched
+	for (int i = 0; i < dispatcher->eventCount && node->subscriptionCount > 0; i++) {
+		Box_EventList* list = &dispatcher->eventLists[i];
+
+		for (int j = 0; j < list->count; j++) {
+			if (list->subscriptions[j].node == node) {
+				unsubscribeUtil(list, j);
+				break;
+			}
+		}
+	}
+}
+
+void Box_invalidateDispatcher(Box_Dispatcher* dispatcher) {
+	dispatcher->dirty = true;
+}
+
+void Box_muteHookDispatcher(Box_Dispatcher* dispatcher, Box_Node* node, Box_LifecycleHook hook, bool muted) {
+	if (muted) {
+		node->mutedHooks |= BOX_HOOK_BIT(hook);
+
+		//stop any call in progress from reaching this node, the tombstone is compacted later
+		removeListUtil(&dispatcher->lists[hook], node, hook);
+	}
+	else {
+		node->mutedHooks &= ~BOX_HOOK_BIT(hook);
+
+		//put it back in tree order
+		dispatcher->dirty = true;
+	}
+}
+
+void Box_subscribeDispatcher(Box_Dispatcher* dispatcher, Box_Node* node, Toy_Literal eventLiteral, Toy_Literal fnLiteral) {
+	Box_EventList* list = getEventListUtil(dispatcher, eventLiteral, true);
+
+	for (int i = 0; i < list->count; i++) {
+		if (list->subscriptions[i].node == node) {
+			Toy_freeLiteral(list->subscriptions[i].fn);
+			list->subscriptions[i].fn = Toy_copyLiteral(fnLiteral);
+			return;
+		}
+	}
+
+	if (list->count + 1 > list->capacity) {
+		int oldCapacity = list->capacity;
+
+		list->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		list->subscriptions = TOY_GROW_ARRAY(Box_EventSubscription, list->subscriptions, oldCapacity, list->capacity);
+	}
+
+	list->subscriptions[list->count].node = node;
+	list->subscriptions[list->count].fn = Toy_copyLiteral(fnLiteral);
+	list->count++;
+
+	node->subscriptionCount++;
+}
+
+void Box_unsubscribeDispatcher(Box_Dispatcher* dispatcher, Box_Node* node, Toy_Literal eventLiteral) {
+	Box_EventList* list = getEventListUtil(dispatcher, eventLiteral, false);
+
+	if (list == NULL) {
+		return;
+	}
+
+	for (int i = 0; i < list->count; i++) {
+		if (list->subscriptions[i].node == node) {
+			unsubscribeUtil(list, i);
+			break;
+		}
+	}
+
+	if (dispatcher->emitDepth == 0) {
+		compactEventListsUtil(dispatcher);
+	}
+}
+
+int Box_emitDispatcher(Box_Dispatcher* dispatcher, Toy_Interpreter* interpreter, Toy_Literal eventLiteral, Toy_LiteralArray* args) {
+	if (!Toy_existsLiteralDictionary(&dispatcher->events, eventLiteral)) {
+		return 0;
+	}
+
+	//the lists can move while emitting, so only hold the index
+	Toy_Literal indexLiteral = Toy_getLiteralDictionary(&dispatcher->events, eventLiteral);
+	int index = TOY_AS_INTEGER(indexLiteral);
+	Toy_freeLiteral(indexLiteral);
+
+	int called = 0;
+
+	dispatcher->emitDepth++;
+
+	//NOTE: the list can grow or gain tombstones while iterating
+	for (int i = 0; i < dispatcher->eventLists[index].count; i++) {
+		Box_EventSubscription subscription = dispatcher->eventLists[index].subscriptions[i];
+
+		if (subscription.node == NULL) {
+			continue;
+		}
+
+		//held, in case the node unsubscribes during the call
+		Toy_Literal fn = Toy_copyLiteral(subscription.fn);
+		Toy_freeLiteral(Box_callNodeLiteral(subscription.node, interpreter, fn, args));
+		Toy_freeLiteral(fn);
+
+		called++;
+	}
+
+	if (--dispatcher->emitDepth == 0) {
+		compactEventListsUtil(dispatcher);
+	}
+
+	return called;
+}
+
+void Box_postDispatcher(Box_Dispatcher* dispatcher, Toy_Literal eventLiteral, Toy_LiteralArray* args) {
+	if (dispatcher->queueCount + 1 > dispatcher->queueCapacity) {
+		int oldCapacity = dispatcher->queueCapacity;
+
+		dispatcher->queueCapacity = TOY_GROW_CAPACITY(oldCapacity);
+		dispatcher->queue = TOY_GROW_ARRAY(Box_QueuedEvent, dispatcher->queue, oldCapacity, dispatcher->queueCapacity);
+	}
+
+	Box_QueuedEvent* queued = &dispatcher->queue[dispatcher->queueCount++];
+
+	queued->event = Toy_copyLiteral(eventLiteral);
+	queued->args = *args; //moved, not copied
+
+	Toy_initLiteralArray(args);
+}
+
+void Box_drainDispatcher(Box_Dispatcher* dispatcher, Toy_Interpreter* interpreter) {
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	int count = dispatcher->queueCount;
+
+	for (int i = 0; i < count; i++) {
+		//copied out, as posting during the emit can move the queue
+		Box_QueuedEvent queued = dispatcher->queue[i];
+
+		Box_emitDispatcher(dispatcher, interpreter, queued.event, &queued.args);
+
+		Toy_freeLiteral(queued.event);
+		Toy_freeLiteralArray(&queued.args);
+	}
+
+	//keep what was posted during the drain for the next one
+	memmove(dispatcher->queue, dispatcher->queue + count, (dispatcher->queueCount - count) * sizeof(Box_QueuedEvent));
+	dispatcher->queueCount -= count;
+
+	dispatcher->drainedCount = count;
+	dispatcher->drainMilliseconds = (float)((SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency());
+}
+
+int Box_countHookDispatcher(Box_Dispatcher* dispatcher, Box_Node* root, Box_LifecycleHook hook) {
+	refreshListUtil(dispatcher, root, hook);
+
+	return dispatcher->lists[hook].count - dispatcher->lists[hook].tombstones;
+}
+
+void Box_callHookDispatcher(Box_Dispatcher* dispatcher, Box_Node* root, Toy_Interpreter* interpreter, Box_LifecycleHook hook, Toy_LiteralArray* args) {
+	//only rebuild or compact between calls, never during one
+	refreshListUtil(dispatcher, root, hook);
+
+	Box_DispatchList* list = &dispatcher->lists[hook];
+
+	dispatcher->callDepth++;
+
+	//NOTE: the list can grow or gain tombstones while iterating
+	for (int i = 0; i < list->count; i++) {
+		if (list->nodes[i] != NULL) {
+			Toy_freeLiteral(Box_callNodeHook(list->nodes[i], interpreter, hook, args));
+		}
+	}
+
+	dispatcher->callDepth--;
+}
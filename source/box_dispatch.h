@@ -0,0 +1,82 @@
+#pragma once
+
+#include "box_common.h"
+#include "box_node.h"
+
+#include "toy_interpreter.h"
+#include "toy_literal_array.h"
+
+//a flat, tree-ordered list of the nodes which define a specific hook
+typedef struct Box_private_dispatch_list {
+	Box_Node** nodes;
+	int capacity;
+	int count; //includes tombstones
+	int tombstones; //dropped in place before the next call, without a rebuild
+} Box_DispatchList;
+
+//a node subscribed to a custom event, and the function to call
+typedef struct Box_private_event_subscription {
+	Box_Node* node; //NULL for tombstones
+	Toy_Literal fn; //identifier
+} Box_EventSubscription;
+
+//the nodes subscribed to a custom event, in the order they subscribed
+typedef struct Box_private_event_list {
+	Box_EventSubscription* subscriptions;
+	int capacity;
+	int count; //includes tombstones
+	bool dirty; //has tombstones to compact
+} Box_EventList;
+
+//an event posted for the next drain
+typedef struct Box_private_queued_event {
+	Toy_Literal event;
+	Toy_LiteralArray args;
+} Box_QueuedEvent;
+
+//one list per lifecycle hook, covering the tree under the root node
+typedef struct Box_private_dispatcher {
+	Box_DispatchList lists[BOX_HOOK_COUNT];
+	bool dirty; //the lists are rebuilt before the next call when set
+	int callDepth; //lists are only compacted outside of calls
+
+	//custom events, which nodes subscribe to at runtime
+	Toy_LiteralDictionary events; //event name -> index into eventLists
+	Box_EventList* eventLists;
+	int eventCapacity;
+	int eventCount;
+	int emitDepth; //tombstones are only compacted outside of emits
+
+	//events posted by scripts, emitted together once per frame
+	Box_QueuedEvent* queue;
+	int queueCapacity;
+	int queueCount;
+
+	//statistics, for the last drain
+	int drainedCount;
+	float drainMilliseconds;
+} Box_Dispatcher;
+
+BOX_API void Box_initDispatcher(Box_Dispatcher* dispatcher);
+BOX_API void Box_freeDispatcher(Box_Dispatcher* dispatcher);
+
+//keep the lists in sync with the tree
+BOX_API void Box_pushDispatcher(Box_Dispatcher* dispatcher, Box_Node* root, Box_Node* parent, Box_Node* child); //call after the child is pushed
+BOX_API void Box_removeDispatcher(Box_Dispatcher* dispatcher, Box_Node* node); //call before the node is freed
+BOX_API void Box_invalidateDispatcher(Box_Dispatcher* dispatcher); //call when the tree is reordered or replaced
+
+//runtime subscriptions
+BOX_API void Box_muteHookDispatcher(Box_Dispatcher* dispatcher, Box_Node* node, Box_LifecycleHook hook, bool muted); //a muted node keeps the hook, but isn't called
+BOX_API void Box_subscribeDispatcher(Box_Dispatcher* dispatcher, Box_Node* node, Toy_Literal eventLiteral, Toy_Literal fnLiteral); //subscribing again replaces the function
+BOX_API void Box_unsubscribeDispatcher(Box_Dispatcher* dispatcher, Box_Node* node, Toy_Literal eventLiteral);
+BOX_API int Box_emitDispatcher(Box_Dispatcher* dispatcher, Toy_Interpreter* interpreter, Toy_Literal eventLiteral, Toy_LiteralArray* args); //returns the number of nodes called
+
+//deferred events
+BOX_API void Box_postDispatcher(Box_Dispatcher* dispatcher, Toy_Literal eventLiteral, Toy_LiteralArray* args); //takes the contents of args, leaving it empty
+BOX_API void Box_drainDispatcher(Box_Dispatcher* dispatcher, Toy_Interpreter* interpreter); //emit everything posted before the call, events posted meanwhile wait for the next drain
+
+//the number of subscribed nodes under root, to skip preparing calls nobody receives
+BOX_API int Box_countHookDispatcher(Box_Dispatcher* dispatcher, Box_Node* root, Box_LifecycleHook hook);
+
+//call "hook" on every subscribed node under root, in tree order
+BOX_API void Box_callHookDispatcher(Box_Dispatcher* dispatcher, Box_Node* root, Toy_Interpreter* interpreter, Box_LifecycleHook hook, Toy_LiteralArray* args);
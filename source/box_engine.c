@@ -1,4 +1,6 @@
 #include "box_engine.h"
+#include "box_pack.h"
+#include "box_file_view.h"
 
 #include "lib_toy_version_info.h"
 #include "lib_box_version_info.h"
@@ -38,18 +40,25 @@ static void fatalError(char* message) {
 	exit(-1);
 }
 
-//exposed functions
-void Box_initEngine(const char* initScript) {
+static void initEngine(const char* initScript) {
 	//clear
 	engine.rootNode = NULL;
 	engine.nextRootNodeFilename = TOY_TO_NULL_LITERAL;
+	engine.pendingRootNodeFilename = TOY_TO_NULL_LITERAL;
 	engine.running = false;
 	engine.window = NULL;
 	engine.renderer = NULL;
+	engine.headlessSurface = NULL;
 	engine.music = NULL;
 
+	Box_initFramePacer(&engine.pacer, BOX_DEFAULT_TARGET_FPS);
+	engine.stepRate = BOX_DEFAULT_STEP_RATE;
+	engine.maxStepsPerFrame = BOX_DEFAULT_MAX_STEPS_PER_FRAME;
+	engine.carryTimeDebt = false;
+	engine.interpolationAlpha = 1.0f;
+
 	//init SDL
-	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
+	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER) != 0) {
 		fatalError("Failed to initialize SDL2");
 	}
 
@@ -72,9 +81,58 @@ void Box_initEngine(const char* initScript) {
 	//init events
 	Toy_initLiteralDictionary(&engine.symKeyDownEvents);
 	Toy_initLiteralDictionary(&engine.symKeyUpEvents);
+	Box_initActionMap(&engine.actionMap);
 
 	//init Toy
 	Toy_initInterpreter(&engine.interpreter);
+	Box_initPacks(); //before the loader threads start
+	Box_initBytecodeCache(&engine.bytecodeCache);
+	Box_initLoader(&engine.loader);
+	Box_initWatcher(&engine.watcher);
+
+	//intern the lifecycle function names, so they're only hashed once
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		engine.hookKeys[i] = TOY_TO_IDENTIFIER_LITERAL(Toy_createRefString(Box_getHookName(i)));
+	}
+
+	//intern the mouse button names, so input events don't allocate
+	engine.mouseButtonNames[0] = TOY_TO_STRING_LITERAL(Toy_createRefString("unknown"));
+	engine.mouseButtonNames[SDL_BUTTON_LEFT] = TOY_TO_STRING_LITERAL(Toy_createRefString("left"));
+	engine.mouseButtonNames[SDL_BUTTON_MIDDLE] = TOY_TO_STRING_LITERAL(Toy_createRefString("middle"));
+	engine.mouseButtonNames[SDL_BUTTON_RIGHT] = TOY_TO_STRING_LITERAL(Toy_createRefString("right"));
+	engine.mouseButtonNames[SDL_BUTTON_X1] = TOY_TO_STRING_LITERAL(Toy_createRefString("x1"));
+	engine.mouseButtonNames[SDL_BUTTON_X2] = TOY_TO_STRING_LITERAL(Toy_createRefString("x2"));
+
+	Toy_initLiteralArray(&engine.eventArgs);
+	engine.inputBatch = NULL;
+	engine.rawMouseMotion = false;
+	engine.motionPending = false;
+	engine.motionX = 0;
+	engine.motionY = 0;
+	engine.motionXRel = 0;
+	engine.motionYRel = 0;
+
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		engine.hookStrings[i] = TOY_TO_STRING_LITERAL(Toy_createRefString(Box_getHookName(i)));
+	}
+
+	for (int i = 0; i < BOX_CALL_FRAME_DEPTH; i++) {
+		Toy_initLiteralArray(&engine.callArguments[i]);
+		Toy_initLiteralArray(&engine.callReturns[i]);
+	}
+	engine.callDepth = 0;
+
+	Box_initDispatcher(&engine.dispatcher);
+	Box_initNodePool(&engine.nodePool);
+	Box_initTransformStore(&engine.transforms);
+	engine.packedTransforms = false;
+	Box_initTextureCache(&engine.textureCache);
+	Box_initAssetLoader(&engine.assetLoader);
+	Box_initFontCache(&engine.fontCache);
+	Box_initGlyphCache(&engine.glyphCache);
+	Box_initSpriteBatch(&engine.spriteBatch);
+	engine.autoDrawCount = 0;
+
 	Toy_injectNativeHook(&engine.interpreter, "toy_version_info", Toy_hookToyVersionInfo);
 	Toy_injectNativeHook(&engine.interpreter, "box_version_info", Toy_hookBoxVersionInfo);
 	Toy_injectNativeHook(&engine.interpreter, "standard", Toy_hookStandard);
@@ -99,21 +157,25 @@ void Box_initEngine(const char* initScript) {
 	}
 
 	size_t size = 0;
-	const unsigned char* source = Toy_readFile(Toy_toCString(TOY_AS_STRING(driveLiteral)), &size);
+	Box_FileView view;
 
-	if (!source) {
+	if (Box_openFileView(&view, Toy_toCString(TOY_AS_STRING(driveLiteral))) != 0) {
 		Toy_freeLiteral(scriptLiteral);
 		Toy_freeLiteral(driveLiteral);
 
 		fatalError("Couldn't read the given init file");
 	}
 
+	//compile the source to bytecode (unless it's precompiled)
+	const unsigned char* tb = Box_compileViewBytecodeCache(&view, Toy_toCString(TOY_AS_STRING(driveLiteral)), &size);
+	Box_closeFileView(&view);
+
 	Toy_freeLiteral(scriptLiteral);
 	Toy_freeLiteral(driveLiteral);
 
-	//compile the source to bytecode
-	const unsigned char* tb = Toy_compileString((const char*)source, &size);
-	free((void*)source);
+	if (tb == NULL) {
+		fatalError("Couldn't compile the given init file");
+	}
 
 	//BUGFIX: make an inner-interpreter for `init.toy` to remove globals
 	Toy_Interpreter inner;
@@ -136,10 +198,26 @@ void Box_initEngine(const char* initScript) {
 	}
 }
 
+//exposed functions
+void Box_initEngine(const char* initScript) {
+	engine.headless = false;
+	initEngine(initScript);
+}
+
+void Box_initHeadlessEngine(const char* initScript) {
+	engine.headless = true;
+
+	//no display or sound card needed
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+	SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+
+	initEngine(initScript);
+}
+
 void Box_freeEngine() {
 	//clear existing root node
 	if (engine.rootNode != NULL) {
-		Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onFree", NULL);
+		Box_callRecursiveNodeHook(engine.rootNode, &engine.interpreter, BOX_HOOK_ON_FREE, NULL);
 		Box_freeNode(engine.rootNode);
 		engine.rootNode = NULL;
 	}
@@ -148,11 +226,44 @@ void Box_freeEngine() {
 		Toy_freeLiteral(engine.nextRootNodeFilename);
 	}
 
+	if (!TOY_IS_NULL(engine.pendingRootNodeFilename)) {
+		Toy_freeLiteral(engine.pendingRootNodeFilename);
+	}
+
+	Box_freeLoader(&engine.loader);
 	Toy_freeInterpreter(&engine.interpreter);
+	Box_freeBytecodeCache(&engine.bytecodeCache);
+	Box_freeWatcher(&engine.watcher);
+
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		Toy_freeLiteral(engine.hookKeys[i]);
+		Toy_freeLiteral(engine.hookStrings[i]);
+	}
+
+	for (int i = 0; i <= SDL_BUTTON_X2; i++) {
+		Toy_freeLiteral(engine.mouseButtonNames[i]);
+	}
+
+	Toy_freeLiteralArray(&engine.eventArgs);
+
+	for (int i = 0; i < BOX_CALL_FRAME_DEPTH; i++) {
+		Toy_freeLiteralArray(&engine.callArguments[i]);
+		Toy_freeLiteralArray(&engine.callReturns[i]);
+	}
+
+	Box_freeDispatcher(&engine.dispatcher);
+	Box_freeNodePool(&engine.nodePool);
+	Box_freeTransformStore(&engine.transforms);
+	Box_freeAssetLoader(&engine.assetLoader);
+	Box_freeTextureCache(&engine.textureCache);
+	Box_freeGlyphCache(&engine.glyphCache);
+	Box_freeFontCache(&engine.fontCache);
+	Box_freeSpriteBatch(&engine.spriteBatch);
 
 	//free events
 	Toy_freeLiteralDictionary(&engine.symKeyDownEvents);
 	Toy_freeLiteralDictionary(&engine.symKeyUpEvents);
+	Box_freeActionMap(&engine.actionMap);
 
 	//free the music
 	if (engine.music != NULL) {
@@ -165,16 +276,27 @@ void Box_freeEngine() {
 	IMG_Quit();
 	Mix_Quit();
 
+	//nothing read from the packs is left
+	Box_freePacks();
+
 	//free SDL
 	SDL_DestroyRenderer(engine.renderer);
 	SDL_DestroyWindow(engine.window);
+	SDL_FreeSurface(engine.headlessSurface);
 	SDL_Quit();
 
 	engine.renderer = NULL;
 	engine.window = NULL;
+	engine.headlessSurface = NULL;
 }
 
 static inline void execLoadRootNode() {
+	//swap in a pending root node once its scripts are compiled, so the old scene runs in the meantime
+	if (!TOY_IS_NULL(engine.pendingRootNodeFilename) && Box_pollLoader(&engine.loader, &engine.interpreter, &engine.bytecodeCache)) {
+		engine.nextRootNodeFilename = engine.pendingRootNodeFilename;
+		engine.pendingRootNodeFilename = TOY_TO_NULL_LITERAL;
+	}
+
 	//if a new root node is NOT needed, skip out
 	if (TOY_IS_NULL(engine.nextRootNodeFilename)) {
 		return;
@@ -182,19 +304,23 @@ static inline void execLoadRootNode() {
 
 	//free the existing root node
 	if (engine.rootNode != NULL) {
-		Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onFree", NULL);
+		Box_callRecursiveNodeHook(engine.rootNode, &engine.interpreter, BOX_HOOK_ON_FREE, NULL);
 		Box_freeNode(engine.rootNode);
 		engine.rootNode = NULL;
 	}
 
-	//compile the new root node
+	//compile the new root node (or fetch it from the cache)
 	size_t size = 0;
-	const unsigned char* source = Toy_readFile(Toy_toCString(TOY_AS_STRING(engine.nextRootNodeFilename)), &size);
-	const unsigned char* tb = Toy_compileString((const char*)source, &size);
-	free((void*)source);
+	Box_BytecodeCacheEntry* entry = NULL;
+	const unsigned char* tb = Box_loadBytecodeCache(&engine.bytecodeCache, engine.nextRootNodeFilename, &size, &entry);
+
+	if (tb == NULL) {
+		fatalError("Couldn't load the root node");
+	}
 
 	//allocate the new root node
-	engine.rootNode = TOY_ALLOCATE(Box_Node, 1);
+	engine.rootNode = Box_allocateNode();
+	Box_invalidateDispatcher(&engine.dispatcher);
 
 	//BUGFIX: make an inner-interpreter
 	Toy_Interpreter inner;
@@ -214,13 +340,12 @@ static inline void execLoadRootNode() {
 	Toy_setInterpreterAssert(&inner, engine.interpreter.assertOutput);
 	Toy_setInterpreterError(&inner, engine.interpreter.errorOutput);
 
-	Box_initNode(engine.rootNode, &inner, tb, size);
+	Box_initSharedNode(engine.rootNode, &inner, tb, size, &entry->functions);
+	Box_trackNodeBytecodeCache(entry, engine.rootNode);
+	Box_attachTransformNode(engine.rootNode); //before onLoad() pushes any children
 
 	//immediately call onLoad() after running the script - for loading other nodes
-	Box_callNode(engine.rootNode, &inner, "onLoad", NULL);
-
-	//cache the scope for later freeing
-	engine.rootNode->scope = inner.scope;
+	Box_callNodeHook(engine.rootNode, &inner, BOX_HOOK_ON_LOAD, NULL);
 
 	//manual cleanup
 	Toy_freeLiteralArray(&inner.stack);
@@ -231,17 +356,80 @@ static inline void execLoadRootNode() {
 	engine.nextRootNodeFilename = TOY_TO_NULL_LITERAL;
 
 	//init the new node-tree
-	Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onInit", NULL);
+	Box_callRecursiveNodeHook(engine.rootNode, &engine.interpreter, BOX_HOOK_ON_INIT, NULL);
+}
+
+//the interned name of a mouse button, which isn't freed
+static Toy_Literal mouseButtonUtil(Uint8 button) {
+	return engine.mouseButtonNames[button <= SDL_BUTTON_X2 ? button : 0];
+}
+
+//call an input hook, and record the event for onInput()
+static void dispatchInputUtil(Box_LifecycleHook hook, Toy_LiteralArray* args) {
+	Box_callHookDispatcher(&engine.dispatcher, engine.rootNode, &engine.interpreter, hook, args);
+
+	if (engine.inputBatch == NULL) {
+		return;
+	}
+
+	//batched as [hookName, args...]
+	Toy_LiteralArray* entry = TOY_ALLOCATE(Toy_LiteralArray, 1);
+	Toy_initLiteralArray(entry);
+	Toy_pushLiteralArray(entry, engine.hookStrings[hook]);
+
+	for (int i = 0; i < args->count; i++) {
+		Toy_pushLiteralArray(entry, args->literals[i]);
+	}
+
+	Toy_Literal entryLiteral = TOY_TO_ARRAY_LITERAL(entry);
+	Toy_pushLiteralArray(engine.inputBatch, entryLiteral);
+	Toy_freeLiteral(entryLiteral);
+}
+
+//deliver the motion coalesced so far as one event
+static void flushMotionUtil(Toy_LiteralArray* args) {
+	if (!engine.motionPending) {
+		return;
+	}
+
+	Toy_pushLiteralArray(args, TOY_TO_INTEGER_LITERAL(engine.motionX));
+	Toy_pushLiteralArray(args, TOY_TO_INTEGER_LITERAL(engine.motionY));
+	Toy_pushLiteralArray(args, TOY_TO_INTEGER_LITERAL(engine.motionXRel));
+	Toy_pushLiteralArray(args, TOY_TO_INTEGER_LITERAL(engine.motionYRel));
+
+	dispatchInputUtil(BOX_HOOK_ON_MOUSE_MOTION, args);
+
+	args->count = 0; //integers need no freeing
+
+	engine.motionPending = false;
+	engine.motionXRel = 0;
+	engine.motionYRel = 0;
 }
 
 static inline void execEvents() {
-	Toy_LiteralArray args; //save some allocation by reusing this
-	Toy_initLiteralArray(&args);
+	Toy_LiteralArray* args = &engine.eventArgs; //keeps its capacity between frames
+
+	//only gather the frame's input if someone wants it
+	if (Box_countHookDispatcher(&engine.dispatcher, engine.rootNode, BOX_HOOK_ON_INPUT) > 0) {
+		engine.inputBatch = TOY_ALLOCATE(Toy_LiteralArray, 1);
+		Toy_initLiteralArray(engine.inputBatch);
+	}
+
+	//"pressed" and "released" only cover this frame
+	Box_startFrameActionMap(&engine.actionMap);
 
 	//poll all events
 	SDL_Event event;
 
 	while (SDL_PollEvent(&event)) {
+		//update the actions before any hook can poll them
+		Box_handleEventActionMap(&engine.actionMap, &event);
+
+		//anything else keeps its place after the motion before it
+		if (event.type != SDL_MOUSEMOTION) {
+			flushMotionUtil(args);
+		}
+
 		switch(event.type) {
 			//quit
 			case SDL_QUIT: {
@@ -280,9 +468,9 @@ static inline void execEvents() {
 				Toy_Literal eventLiteral = Toy_getLiteralDictionary(&engine.symKeyDownEvents, keycodeLiteral);
 
 				//call the function
-				Toy_pushLiteralArray(&args, eventLiteral);
-				Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onKeyDown", &args);
-				Toy_freeLiteral(Toy_popLiteralArray(&args));
+				Toy_pushLiteralArray(args, eventLiteral);
+				dispatchInputUtil(BOX_HOOK_ON_KEY_DOWN, args);
+				Toy_freeLiteral(Toy_popLiteralArray(args));
 
 				//push to the event list
 				Toy_freeLiteral(eventLiteral);
@@ -307,9 +495,9 @@ static inline void execEvents() {
 				Toy_Literal eventLiteral = Toy_getLiteralDictionary(&engine.symKeyUpEvents, keycodeLiteral);
 
 				//call the function
-				Toy_pushLiteralArray(&args, eventLiteral);
-				Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onKeyUp", &args);
-				Toy_freeLiteral(Toy_popLiteralArray(&args));
+				Toy_pushLiteralArray(args, eventLiteral);
+				dispatchInputUtil(BOX_HOOK_ON_KEY_UP, args);
+				Toy_freeLiteral(Toy_popLiteralArray(args));
 
 				//push to the event list
 				Toy_freeLiteral(eventLiteral);
@@ -319,17 +507,26 @@ static inline void execEvents() {
 
 			//mouse motion
 			case SDL_MOUSEMOTION: {
+				if (!engine.rawMouseMotion) {
+					engine.motionPending = true;
+					engine.motionX = event.motion.x;
+					engine.motionY = event.motion.y;
+					engine.motionXRel += event.motion.xrel;
+					engine.motionYRel += event.motion.yrel;
+					break;
+				}
+
 				Toy_Literal mouseX = TOY_TO_INTEGER_LITERAL( (int)(event.motion.x) );
 				Toy_Literal mouseY = TOY_TO_INTEGER_LITERAL( (int)(event.motion.y) );
 				Toy_Literal mouseXRel = TOY_TO_INTEGER_LITERAL( (int)(event.motion.xrel) );
 				Toy_Literal mouseYRel = TOY_TO_INTEGER_LITERAL( (int)(event.motion.yrel) );
 
-				Toy_pushLiteralArray(&args, mouseX);
-				Toy_pushLiteralArray(&args, mouseY);
-				Toy_pushLiteralArray(&args, mouseXRel);
-				Toy_pushLiteralArray(&args, mouseYRel);
+				Toy_pushLiteralArray(args, mouseX);
+				Toy_pushLiteralArray(args, mouseY);
+				Toy_pushLiteralArray(args, mouseXRel);
+				Toy_pushLiteralArray(args, mouseYRel);
 
-				Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onMouseMotion", &args);
+				dispatchInputUtil(BOX_HOOK_ON_MOUSE_MOTION, args);
 
 				Toy_freeLiteral(mouseX);
 				Toy_freeLiteral(mouseY);
@@ -337,10 +534,10 @@ static inline void execEvents() {
 				Toy_freeLiteral(mouseYRel);
 
 				//hack: manual free
-				for(int i = 0; i < args.count; i++) {
-					Toy_freeLiteral(args.literals[i]);
+				for(int i = 0; i < args->count; i++) {
+					Toy_freeLiteral(args->literals[i]);
 				}
-				args.count = 0;
+				args->count = 0;
 			}
 			break;
 
@@ -348,49 +545,22 @@ static inline void execEvents() {
 			case SDL_MOUSEBUTTONDOWN: {
 				Toy_Literal mouseX = TOY_TO_INTEGER_LITERAL( (int)(event.button.x) );
 				Toy_Literal mouseY = TOY_TO_INTEGER_LITERAL( (int)(event.button.y) );
-				Toy_Literal mouseButton;
+				Toy_Literal mouseButton = mouseButtonUtil(event.button.button);
 
-				switch (event.button.button) {
-					case SDL_BUTTON_LEFT:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("left"));
-						break;
+				Toy_pushLiteralArray(args, mouseX);
+				Toy_pushLiteralArray(args, mouseY);
+				Toy_pushLiteralArray(args, mouseButton);
 
-					case SDL_BUTTON_MIDDLE:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("middle"));
-						break;
-
-					case SDL_BUTTON_RIGHT:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("right"));
-						break;
-
-					case SDL_BUTTON_X1:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("x1"));
-						break;
-
-					case SDL_BUTTON_X2:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("x2"));
-						break;
-
-					default:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("unknown"));
-						break;
-				}
-
-				Toy_pushLiteralArray(&args, mouseX);
-				Toy_pushLiteralArray(&args, mouseY);
-				Toy_pushLiteralArray(&args, mouseButton);
-
-				Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onMouseButtonDown", &args);
+				dispatchInputUtil(BOX_HOOK_ON_MOUSE_BUTTON_DOWN, args);
 
 				Toy_freeLiteral(mouseX);
 				Toy_freeLiteral(mouseY);
-				Toy_freeLiteral(mouseButton);
 
 				//hack: manual free
-				for(int i = 0; i < args.count; i++) {
-					Toy_freeLiteral(args.literals[i]);
+				for(int i = 0; i < args->count; i++) {
+					Toy_freeLiteral(args->literals[i]);
 				}
-				args.count = 0;
+				args->count = 0;
 			}
 			break;
 
@@ -398,49 +568,22 @@ static inline void execEvents() {
 			case SDL_MOUSEBUTTONUP: {
 				Toy_Literal mouseX = TOY_TO_INTEGER_LITERAL( (int)(event.button.x) );
 				Toy_Literal mouseY = TOY_TO_INTEGER_LITERAL( (int)(event.button.y) );
-				Toy_Literal mouseButton;
-
-				switch (event.button.button) {
-					case SDL_BUTTON_LEFT:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("left"));
-						break;
-
-					case SDL_BUTTON_MIDDLE:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("middle"));
-						break;
+				Toy_Literal mouseButton = mouseButtonUtil(event.button.button);
 
-					case SDL_BUTTON_RIGHT:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("right"));
-						break;
+				Toy_pushLiteralArray(args, mouseX);
+				Toy_pushLiteralArray(args, mouseY);
+				Toy_pushLiteralArray(args, mouseButton);
 
-					case SDL_BUTTON_X1:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("x1"));
-						break;
-
-					case SDL_BUTTON_X2:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("x2"));
-						break;
-
-					default:
-						mouseButton = TOY_TO_STRING_LITERAL(Toy_createRefString("unknown"));
-						break;
-				}
-
-				Toy_pushLiteralArray(&args, mouseX);
-				Toy_pushLiteralArray(&args, mouseY);
-				Toy_pushLiteralArray(&args, mouseButton);
-
-				Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onMouseButtonUp", &args);
+				dispatchInputUtil(BOX_HOOK_ON_MOUSE_BUTTON_UP, args);
 
 				Toy_freeLiteral(mouseX);
 				Toy_freeLiteral(mouseY);
-				Toy_freeLiteral(mouseButton);
 
 				//hack: manual free
-				for(int i = 0; i < args.count; i++) {
-					Toy_freeLiteral(args.literals[i]);
+				for(int i = 0; i < args->count; i++) {
+					Toy_freeLiteral(args->literals[i]);
 				}
-				args.count = 0;
+				args->count = 0;
 			}
 			break;
 
@@ -448,34 +591,53 @@ static inline void execEvents() {
 			case SDL_MOUSEWHEEL: {
 				Toy_Literal mouseX = TOY_TO_INTEGER_LITERAL( (int)(event.wheel.x) );
 				Toy_Literal mouseY = TOY_TO_INTEGER_LITERAL( (int)(event.wheel.y) );
-				Toy_pushLiteralArray(&args, mouseX);
-				Toy_pushLiteralArray(&args, mouseY);
+				Toy_pushLiteralArray(args, mouseX);
+				Toy_pushLiteralArray(args, mouseY);
 
-				Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onMouseWheel", &args);
+				dispatchInputUtil(BOX_HOOK_ON_MOUSE_WHEEL, args);
 
 				Toy_freeLiteral(mouseX);
 				Toy_freeLiteral(mouseY);
 
 				//hack: manual free
-				for(int i = 0; i < args.count; i++) {
-					Toy_freeLiteral(args.literals[i]);
+				for(int i = 0; i < args->count; i++) {
+					Toy_freeLiteral(args->literals[i]);
 				}
-				args.count = 0;
+				args->count = 0;
 			}
 			break;
 		}
 	}
 
-	Toy_freeLiteralArray(&args);
+	flushMotionUtil(args);
+
+	//the whole frame's input, in one call
+	if (engine.inputBatch != NULL) {
+		Toy_Literal batchLiteral = TOY_TO_ARRAY_LITERAL(engine.inputBatch); //takes ownership
+		engine.inputBatch = NULL;
+
+		if (TOY_AS_ARRAY(batchLiteral)->count > 0) {
+			Toy_pushLiteralArray(args, batchLiteral);
+			Box_callHookDispatcher(&engine.dispatcher, engine.rootNode, &engine.interpreter, BOX_HOOK_ON_INPUT, args);
+			Toy_freeLiteral(Toy_popLiteralArray(args));
+		}
+
+		Toy_freeLiteral(batchLiteral);
+	}
 }
 
 static inline void execStep() {
 	if (engine.rootNode != NULL) {
 		//move nodes first, so collisions can be checked in code
-		Box_movePositionByMotionRecursiveNode(engine.rootNode);
+		if (engine.packedTransforms) {
+			Box_integrateTransformStore(&engine.transforms);
+		}
+		else {
+			Box_movePositionByMotionRecursiveNode(engine.rootNode);
+		}
 
 		//steps
-		Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onStep", NULL);
+		Box_callHookDispatcher(&engine.dispatcher, engine.rootNode, &engine.interpreter, BOX_HOOK_ON_STEP, NULL);
 	}
 }
 
@@ -484,107 +646,200 @@ static inline void execUpdate(int deltaTime) {
 		//create the args
 		Toy_Literal deltaLiteral = TOY_TO_INTEGER_LITERAL(deltaTime);
 
-		Toy_LiteralArray args;
-		Toy_initLiteralArray(&args);
-		Toy_pushLiteralArray(&args, deltaLiteral);
+		Toy_pushLiteralArray(&engine.eventArgs, deltaLiteral);
 
 		Toy_freeLiteral(deltaLiteral);
 
 		//updates
-		Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onUpdate", &args);
+		Box_callHookDispatcher(&engine.dispatcher, engine.rootNode, &engine.interpreter, BOX_HOOK_ON_UPDATE, &engine.eventArgs);
 
-		//free
-		Toy_freeLiteralArray(&args);
+		//empty it, keeping the capacity
+		Toy_freeLiteral(Toy_popLiteralArray(&engine.eventArgs));
 	}
 }
 
-//the heart of the engine
-void Box_execEngine() {
+//run a single frame
+static void execFrame(Dbg_Timer* dbgTimer) {
+	Dbg_startTimer(dbgTimer, "execLoadRootNode()");
+	execLoadRootNode();
+	Dbg_stopTimer(dbgTimer);
+
+	//deliver the events scripts posted since the last frame
+	Dbg_startTimer(dbgTimer, "event bus");
+	Box_drainDispatcher(&engine.dispatcher, &engine.interpreter);
+	Dbg_stopTimer(dbgTimer);
+
+	//swap in the scripts changed on disk, without rebuilding the tree
+	Dbg_startTimer(dbgTimer, "hot reload");
+	if (Box_pollWatcher(&engine.watcher)) {
+		Box_reloadBytecodeCache(&engine.bytecodeCache, &engine.interpreter);
+	}
+	Dbg_stopTimer(dbgTimer);
+
+	//calc the time values
+	const Uint64 stepTicks = engine.clockFrequency / engine.stepRate;
+	const int lastRealTime = engine.realTime;
+
+	engine.realTicks = engine.headless ? engine.realTicks + stepTicks : SDL_GetPerformanceCounter();
+	engine.realTime = (int)((engine.realTicks - engine.startTicks) * 1000 / engine.clockFrequency);
+	engine.deltaTime = engine.realTime - lastRealTime;
+
+	Dbg_startTimer(dbgTimer, "onFrameStart()");
+	Box_callHookDispatcher(&engine.dispatcher, engine.rootNode, &engine.interpreter, BOX_HOOK_ON_FRAME_START, NULL);
+	Dbg_stopTimer(dbgTimer);
+
+	//execute events
+	Dbg_startTimer(dbgTimer, "execEvents()");
+	execEvents();
+	Dbg_stopTimer(dbgTimer);
+
+	//finish the async loads
+	Dbg_startTimer(dbgTimer, "asset uploads");
+	Box_pumpAssetLoader(&engine.assetLoader, &engine.interpreter);
+	Dbg_stopTimer(dbgTimer);
+
+	//execute update
+	Dbg_startTimer(dbgTimer, "execUpdate() (variable-delta)");
+	execUpdate(engine.deltaTime);
+	Dbg_stopTimer(dbgTimer);
+
+	//execute fixed steps
+	Dbg_startTimer(dbgTimer, "execStep() (fixed-delta)");
+	//while not enough time has passed
+	int steps = 0;
+	while(engine.simTicks < engine.realTicks) {
+		//don't spiral after a stall
+		if (engine.maxStepsPerFrame > 0 && steps >= engine.maxStepsPerFrame) {
+			if (!engine.carryTimeDebt) {
+				engine.simTicks = engine.realTicks;
+			}
+			break;
+		}
+
+		//simulate the world
+		execStep();
+		steps++;
+
+		//calc the time simulation
+		engine.simTicks += stepTicks;
+	}
+
+	//the simulation is up to one step ahead, so drawing can interpolate back
+	if (engine.simTicks > engine.realTicks) {
+		engine.interpolationAlpha = 1.0f - (float)(engine.simTicks - engine.realTicks) / stepTicks;
+	}
+	else {
+		engine.interpolationAlpha = 1.0f;
+	}
+	Dbg_stopTimer(dbgTimer);
+
+	//render the world
+	Dbg_startTimer(dbgTimer, "screen clear");
+	SDL_SetRenderDrawColor(engine.renderer, 0, 0, 0, 255); //NOTE: This line can be disabled later
+	SDL_RenderClear(engine.renderer); //NOTE: This line can be disabled later
+	Dbg_stopTimer(dbgTimer);
+
+	Dbg_startTimer(dbgTimer, "world transforms");
+	if (engine.rootNode != NULL) {
+		Box_updateWorldRecursiveNode(engine.rootNode);
+	}
+	Dbg_stopTimer(dbgTimer);
+
+	Dbg_startTimer(dbgTimer, "auto draw");
+	if (engine.rootNode != NULL && engine.autoDrawCount > 0) {
+		Box_autoDrawRecursiveNode(engine.rootNode);
+	}
+	Dbg_stopTimer(dbgTimer);
+
+	Dbg_startTimer(dbgTimer, "onDraw()");
+	Box_callHookDispatcher(&engine.dispatcher, engine.rootNode, &engine.interpreter, BOX_HOOK_ON_DRAW, NULL);
+	Dbg_stopTimer(dbgTimer);
+
+	Dbg_startTimer(dbgTimer, "sprite batch");
+	Box_flushSpriteBatch(&engine.spriteBatch, engine.renderer);
+	Dbg_stopTimer(dbgTimer);
+
+	Dbg_startTimer(dbgTimer, "screen render");
+	SDL_RenderPresent(engine.renderer);
+	Dbg_stopTimer(dbgTimer);
+
+	Dbg_startTimer(dbgTimer, "onFrameEnd()");
+	Box_callHookDispatcher(&engine.dispatcher, engine.rootNode, &engine.interpreter, BOX_HOOK_ON_FRAME_END, NULL);
+	Dbg_stopTimer(dbgTimer);
+}
+
+//load the first root node, and set up time
+static void startEngine() {
 	if (!engine.running) {
 		fatalError("Can't execute the engine (did you forget to initialize the screen?)");
 	}
 
-	//set up time
-	engine.realTime = SDL_GetTicks();
-	engine.simTime = engine.realTime;
-	engine.deltaTime = 0;
-	const int fixedStep = 1000 / 60;
+	//already started
+	if (engine.rootNode != NULL) {
+		return;
+	}
 
-	Dbg_Timer dbgTimer;
-	Dbg_FPSCounter fps;
+	//set up time (simulated when headless, so every run is the same)
+	engine.clockFrequency = SDL_GetPerformanceFrequency();
+	engine.startTicks = engine.headless ? 0 : SDL_GetPerformanceCounter();
+	engine.realTicks = engine.startTicks;
+	engine.simTicks = engine.startTicks;
+	engine.realTime = 0;
+	engine.deltaTime = 0;
 
-	Dbg_initTimer(&dbgTimer);
-	Dbg_initFPSCounter(&fps);
+	//initial root node check (nothing to show in the meantime, so wait for the loader)
+	while (!TOY_IS_NULL(engine.pendingRootNodeFilename) && TOY_IS_NULL(engine.nextRootNodeFilename)) {
+		execLoadRootNode();
+		SDL_Delay(1);
+	}
 
-	//initial root node check
 	execLoadRootNode();
 	if (engine.rootNode == NULL) {
 		fatalError("No root node found (did you forget to load one?)");
 	}
+}
 
-	while (engine.running) {
-		Dbg_tickFPSCounter(&fps);
+//the heart of the engine
+void Box_execEngine() {
+	startEngine();
 
-		Dbg_clearConsole();
-		Dbg_printTimerLog(&dbgTimer);
-		Dbg_printFPSCounter(&fps);
+	Dbg_Timer dbgTimer;
+	Dbg_FPSCounter fps;
 
-		Dbg_startTimer(&dbgTimer, "execLoadRootNode()");
-		execLoadRootNode();
-		Dbg_stopTimer(&dbgTimer);
-
-		//calc the time values
-		const int lastRealTime = engine.realTime;
-		engine.realTime = SDL_GetTicks();
-		engine.deltaTime = engine.realTime - lastRealTime;
-
-		Dbg_startTimer(&dbgTimer, "onFrameStart()");
-		Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onFrameStart", NULL);
-		Dbg_stopTimer(&dbgTimer);
-
-		//execute events
-		Dbg_startTimer(&dbgTimer, "execEvents()");
-		execEvents();
-		Dbg_stopTimer(&dbgTimer);
-
-		//execute update
-		Dbg_startTimer(&dbgTimer, "execUpdate() (variable-delta)");
-		execUpdate(engine.deltaTime);
-		Dbg_stopTimer(&dbgTimer);
-
-		//execute fixed steps
-		Dbg_startTimer(&dbgTimer, "execStep() (fixed-delta)");
-		//while not enough time has passed
-		while(engine.simTime < engine.realTime) {
-			//simulate the world
-			execStep();
-
-			//calc the time simulation
-			engine.simTime += fixedStep;
+	Dbg_initTimer(&dbgTimer);
+	Dbg_initFPSCounter(&fps);
+
+	while (engine.running) {
+		//nobody is watching the console on a headless run
+		if (!engine.headless) {
+			Dbg_tickFPSCounter(&fps);
+
+			Dbg_clearConsole();
+			Dbg_printTimerLog(&dbgTimer);
+			Dbg_printFPSCounter(&fps);
 		}
-		Dbg_stopTimer(&dbgTimer);
 
-		//render the world
-		Dbg_startTimer(&dbgTimer, "screen clear");
-		SDL_SetRenderDrawColor(engine.renderer, 0, 0, 0, 255); //NOTE: This line can be disabled later
-		SDL_RenderClear(engine.renderer); //NOTE: This line can be disabled later
-		Dbg_stopTimer(&dbgTimer);
+		execFrame(&dbgTimer);
 
-		Dbg_startTimer(&dbgTimer, "onDraw()");
-		Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onDraw", NULL);
-		Dbg_stopTimer(&dbgTimer);
+		if (!engine.headless) {
+			Box_waitFramePacer(&engine.pacer);
+		}
+	}
+
+	Dbg_freeTimer(&dbgTimer);
+	Dbg_freeFPSCounter(&fps);
+}
 
-		Dbg_startTimer(&dbgTimer, "screen render");
-		SDL_RenderPresent(engine.renderer);
-		Dbg_stopTimer(&dbgTimer);
+void Box_execFramesEngine(int frames) {
+	startEngine();
 
-		Dbg_startTimer(&dbgTimer, "onFrameEnd()");
-		Box_callRecursiveNode(engine.rootNode, &engine.interpreter, "onFrameEnd", NULL);
-		Dbg_stopTimer(&dbgTimer);
+	Dbg_Timer dbgTimer;
+	Dbg_initTimer(&dbgTimer);
 
-		SDL_Delay(10);
+	//as fast as possible
+	for (int i = 0; i < frames && engine.running; i++) {
+		execFrame(&dbgTimer);
 	}
 
 	Dbg_freeTimer(&dbgTimer);
-	Dbg_freeFPSCounter(&fps);
 }
@@ -2,27 +2,91 @@
 
 #include "box_common.h"
 #include "box_node.h"
+#include "box_bytecode_cache.h"
+#include "box_loader.h"
+#include "box_watcher.h"
+#include "box_dispatch.h"
+#include "box_node_pool.h"
+#include "box_transform_store.h"
+#include "box_sprite_batch.h"
+#include "box_font_cache.h"
+#include "box_asset_loader.h"
+#include "box_action_map.h"
+#include "box_frame_pacer.h"
 
 #include "toy_interpreter.h"
 #include "toy_literal_array.h"
 #include "toy_literal_dictionary.h"
 
+//fixed simulation steps per second
+#define BOX_DEFAULT_STEP_RATE 60
+
+//after a stall, only this many steps are run per frame
+#define BOX_DEFAULT_MAX_STEPS_PER_FRAME 8
+
+//nested node calls beyond this depth use temporary argument frames
+#define BOX_CALL_FRAME_DEPTH 16
+
 //the base engine object, which represents the state of the game
 typedef struct Box_private_engine {
 	//engine stuff
 	Box_Node* rootNode;
 	Toy_Literal nextRootNodeFilename;
-	int simTime;
-	int realTime; //also used as deltaTick
-	int deltaTime;
+	Toy_Literal pendingRootNodeFilename; //becomes nextRootNodeFilename once the loader is done with it
+	int realTime; //milliseconds since starting
+	int deltaTime; //milliseconds since the last frame
 	bool running;
 
+	//time in clock ticks, for precision
+	Uint64 clockFrequency;
+	Uint64 startTicks;
+	Uint64 realTicks;
+	Uint64 simTicks;
+	Box_FramePacer pacer;
+
+	//fixed steps
+	int stepRate; //steps per second
+	int maxStepsPerFrame; //0 means no limit
+	bool carryTimeDebt; //if set, steps skipped by the limit are run over the following frames, otherwise they're dropped
+	float interpolationAlpha; //how far between the last two steps the current frame is, from 0 to 1
+	bool headless; //no window or display, and a simulated clock
+
 	//Toy stuff
 	Toy_Interpreter interpreter;
+	Box_BytecodeCache bytecodeCache; //compiled node scripts
+	Box_Loader loader; //compiles the pending root node's scripts in the background
+	Box_Watcher watcher; //only active while hot-reloading
+	Toy_Literal hookKeys[BOX_HOOK_COUNT]; //interned lifecycle function names
+	Toy_Literal mouseButtonNames[SDL_BUTTON_X2 + 1]; //interned, indexed by SDL's button number ("unknown" at 0)
+	Toy_LiteralArray eventArgs; //reused by every input event
+	Toy_Literal hookStrings[BOX_HOOK_COUNT]; //interned, naming the events batched for onInput()
+	Toy_LiteralArray* inputBatch; //this frame's events, or NULL when no node has onInput()
+
+	//mouse motion is coalesced to one event per frame, unless raw
+	bool rawMouseMotion;
+	bool motionPending;
+	int motionX; //the last absolute position
+	int motionY;
+	int motionXRel; //the relative motion, summed
+	int motionYRel;
+	Toy_LiteralArray callArguments[BOX_CALL_FRAME_DEPTH]; //reused by the node calls, one per nesting level
+	Toy_LiteralArray callReturns[BOX_CALL_FRAME_DEPTH];
+	int callDepth;
+	Box_Dispatcher dispatcher; //flat lists of the nodes which define each hook
+	Box_NodePool nodePool; //recycled node memory
+	Box_TransformStore transforms; //only used while packedTransforms is set
+	bool packedTransforms; //store node transforms in parallel arrays, and integrate them in one pass
 
 	//SDL stuff
 	SDL_Window* window;
 	SDL_Renderer* renderer;
+	SDL_Surface* headlessSurface; //rendered to in software when headless
+	Box_TextureCache textureCache; //images loaded from files, shared between nodes
+	Box_AssetLoader assetLoader; //decodes files in the background, for the async loads
+	Box_FontCache fontCache; //fonts opened by setNodeText()
+	Box_GlyphCache glyphCache; //rasterized fonts used by setNodeGlyphText()
+	Box_SpriteBatch spriteBatch; //flushed after onDraw(), and when the render target changes
+	int autoDrawCount; //nodes with autoDraw set
 	int screenWidth;
 	int screenHeight;
 
@@ -32,6 +96,9 @@ typedef struct Box_private_engine {
 	//input syms mapped to events
 	Toy_LiteralDictionary symKeyDownEvents; //keysym -> event names
 	Toy_LiteralDictionary symKeyUpEvents; //keysym -> event names
+
+	//named actions, bound to keys, mouse buttons and gamepads, which scripts can poll
+	Box_ActionMap actionMap;
 } Box_Engine;
 
 //extern singleton - used by various libraries
@@ -39,6 +106,8 @@ extern Box_Engine engine;
 
 //APIs for running the engine in main()
 BOX_API void Box_initEngine(const char* initScript);
+BOX_API void Box_initHeadlessEngine(const char* initScript); //uses SDL's dummy drivers, for servers and CI machines
 BOX_API void Box_execEngine();
+BOX_API void Box_execFramesEngine(int frames); //run "frames" frames as fast as possible, then return (can be called again)
 BOX_API void Box_freeEngine();
 
@@ -0,0 +1,224 @@
+#include "box_file_view.h"
+#include "box_pack.h"
+
+#include "toy_memory.h"
+#include "toy_console_colors.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//utils
+static void clearViewUtil(Box_FileView* view) {
+	view->data = NULL;
+	view->size = 0;
+	view->terminated = false;
+	view->mapping = NULL;
+	view->mappingSize = 0;
+	view->buffer = NULL;
+#if defined(_WIN32)
+	view->file = INVALID_HANDLE_VALUE;
+	view->map = NULL;
+#endif
+}
+
+static size_t pageSizeUtil() {
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (size_t)info.dwPageSize;
+#else
+	return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+//read the whole file instead, for things that can't be mapped
+static int readFileUtil(Box_FileView* view, const char* filePath) {
+	FILE* file = fopen(filePath, "rb");
+
+	if (file == NULL) {
+		return -1;
+	}
+
+	fseek(file, 0L, SEEK_END);
+	long size = ftell(file);
+	rewind(file);
+
+	if (size < 0) {
+		fclose(file);
+		return -1;
+	}
+
+	view->buffer = TOY_ALLOCATE(unsigned char, size + 1);
+
+	if (fread(view->buffer, sizeof(unsigned char), size, file) != (size_t)size) {
+		TOY_FREE_ARRAY(unsigned char, view->buffer, size + 1);
+		view->buffer = NULL;
+		fclose(file);
+		return -1;
+	}
+
+	fclose(file);
+
+	view->buffer[size] = '\0';
+	view->data = view->buffer;
+	view->size = (size_t)size;
+	view->terminated = true;
+
+	return 0;
+}
+
+//exposed functions
+int Box_openFileView(Box_FileView* view, const char* filePath) {
+	clearViewUtil(view);
+
+	//packed files stay mapped for as long as their pack
+	size_t size = 0;
+	bool terminated = false;
+	const unsigned char* packed = Box_findPack(filePath, &size, &terminated);
+
+	if (packed != NULL) {
+		view->data = packed;
+		view->size = size;
+		view->terminated = terminated;
+		return 0;
+	}
+
+	return Box_mapFileView(view, filePath);
+}
+
+int Box_readFileView(Box_FileView* view, const char* filePath) {
+	clearViewUtil(view);
+
+	//packed files can't change while mounted
+	size_t size = 0;
+	bool terminated = false;
+	const unsigned char* packed = Box_findPack(filePath, &size, &terminated);
+
+	if (packed != NULL) {
+		view->data = packed;
+		view->size = size;
+		view->terminated = terminated;
+		return 0;
+	}
+
+	if (readFileUtil(view, filePath) != 0) {
+		fprintf(stderr, TOY_CC_ERROR "Could not read file \"%s\"\n" TOY_CC_RESET, filePath);
+		return -1;
+	}
+
+	return 0;
+}
+
+int Box_mapFileView(Box_FileView* view, const char* filePath) {
+	clearViewUtil(view);
+
+#if defined(_WIN32)
+	view->file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (view->file == INVALID_HANDLE_VALUE) {
+		fprintf(stderr, TOY_CC_ERROR "Could not open file \"%s\"\n" TOY_CC_RESET, filePath);
+		return -1;
+	}
+
+	LARGE_INTEGER size;
+	GetFileSizeEx(view->file, &size);
+	view->mappingSize = (size_t)size.QuadPart;
+
+	//empty files can't be mapped
+	if (view->mappingSize > 0) {
+		view->map = CreateFileMappingA(view->file, NULL, PAGE_READONLY, 0, 0, NULL);
+		view->mapping = view->map != NULL ? MapViewOfFile(view->map, FILE_MAP_READ, 0, 0, 0) : NULL;
+	}
+
+	if (view->mapping == NULL) {
+		if (view->map != NULL) {
+			CloseHandle(view->map);
+		}
+		CloseHandle(view->file);
+		clearViewUtil(view);
+
+		if (readFileUtil(view, filePath) != 0) {
+			fprintf(stderr, TOY_CC_ERROR "Could not read file \"%s\"\n" TOY_CC_RESET, filePath);
+			return -1;
+		}
+
+		return 0;
+	}
+#else
+	int fd = open(filePath, O_RDONLY);
+
+	if (fd < 0) {
+		fprintf(stderr, TOY_CC_ERROR "Could not open file \"%s\"\n" TOY_CC_RESET, filePath);
+		return -1;
+	}
+
+	struct stat fileStat;
+	void* mapping = MAP_FAILED;
+
+	//empty files can't be mapped
+	if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+		mapping = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+
+	close(fd); //the mapping holds its own reference
+
+	if (mapping == MAP_FAILED) {
+		if (readFileUtil(view, filePath) != 0) {
+			fprintf(stderr, TOY_CC_ERROR "Could not read file \"%s\"\n" TOY_CC_RESET, filePath);
+			return -1;
+		}
+
+		return 0;
+	}
+
+	view->mapping = mapping;
+	view->mappingSize = (size_t)fileStat.st_size;
+#endif
+
+	view->data = view->mapping;
+	view->size = view->mappingSize;
+
+	//the rest of the last page is zero-filled, unless the file ends exactly on a page boundary
+	view->terminated = view->mappingSize % pageSizeUtil() != 0;
+
+	return 0;
+}
+
+void Box_closeFileView(Box_FileView* view) {
+	if (view->mapping != NULL) {
+#if defined(_WIN32)
+		UnmapViewOfFile(view->mapping);
+		CloseHandle(view->map);
+		CloseHandle(view->file);
+#else
+		munmap(view->mapping, view->mappingSize);
+#endif
+	}
+
+	if (view->buffer != NULL) {
+		TOY_FREE_ARRAY(unsigned char, view->buffer, view->size + 1);
+	}
+
+	clearViewUtil(view);
+}
+
+const char* Box_getStringFileView(Box_FileView* view) {
+	if (!view->terminated) {
+		view->buffer = TOY_ALLOCATE(unsigned char, view->size + 1);
+
+		memcpy(view->buffer, view->data, view->size);
+		view->buffer[view->size] = '\0';
+
+		view->data = view->buffer;
+		view->terminated = true;
+	}
+
+	return (const char*)view->data;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "box_common.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+//a read-only view of a file's contents, which must be closed once no longer needed
+typedef struct Box_private_file_view {
+	const unsigned char* data;
+	size_t size;
+	bool terminated; //data[size] is '\0', so the view can be read as a string without a copy
+
+	//how to close it
+	void* mapping;
+	size_t mappingSize;
+	unsigned char* buffer; //used when the file couldn't be mapped
+#if defined(_WIN32)
+	HANDLE file;
+	HANDLE map;
+#endif
+} Box_FileView;
+
+BOX_API int Box_openFileView(Box_FileView* view, const char* filePath); //checks the mounted packs, then maps the file - returns 0 on success
+BOX_API int Box_readFileView(Box_FileView* view, const char* filePath); //as above, but copies loose files - for files which may be mid-save, as a mapping faults if its file shrinks
+BOX_API int Box_mapFileView(Box_FileView* view, const char* filePath); //maps the file, ignoring the packs - the file must not be truncated while mapped, so replace it instead
+BOX_API void Box_closeFileView(Box_FileView* view);
+
+BOX_API const char* Box_getStringFileView(Box_FileView* view); //the contents as a string, only copied if the view isn't terminated (the copy is freed on closing)
@@ -0,0 +1,61 @@
+#include "box_font_cache.h"
+#include "box_pack.h"
+
+#include "toy_memory.h"
+
+#include <stdio.h>
+
+//exposed functions
+void Box_initFontCache(Box_FontCache* cache) {
+	Toy_initLiteralDictionary(&cache->fonts);
+}
+
+void Box_freeFontCache(Box_FontCache* cache) {
+	//the fonts are opaque, so close them manually
+	for (int i = 0; i < cache->fonts.capacity; i++) {
+		if (TOY_IS_NULL(cache->fonts.entries[i].key)) {
+			continue;
+		}
+
+		TTF_CloseFont(TOY_AS_OPAQUE(cache->fonts.entries[i].value));
+	}
+
+	Toy_freeLiteralDictionary(&cache->fonts);
+}
+
+TTF_Font* Box_loadFontCache(Box_FontCache* cache, Toy_Literal filePathLiteral, int pointSize) {
+	if (!TOY_IS_STRING(filePathLiteral)) {
+		return NULL;
+	}
+
+	const char* filePath = Toy_toCString(TOY_AS_STRING(filePathLiteral));
+
+	//the same file at different sizes needs different fonts
+	size_t length = Toy_lengthRefString(TOY_AS_STRING(filePathLiteral)) + 16;
+	char* buffer = TOY_ALLOCATE(char, length);
+	snprintf(buffer, length, "%d:%s", pointSize, filePath);
+
+	Toy_Literal keyLiteral = TOY_TO_STRING_LITERAL(Toy_createRefString(buffer));
+	TOY_FREE_ARRAY(char, buffer, length);
+
+	TTF_Font* font = NULL;
+
+	if (Toy_existsLiteralDictionary(&cache->fonts, keyLiteral)) {
+		Toy_Literal fontLiteral = Toy_getLiteralDictionary(&cache->fonts, keyLiteral);
+		font = TOY_AS_OPAQUE(fontLiteral);
+		Toy_freeLiteral(fontLiteral);
+	}
+	else {
+		font = TTF_OpenFontRW(Box_openRWPack(filePath), 1, pointSize);
+
+		if (font != NULL) {
+			Toy_Literal fontLiteral = TOY_TO_OPAQUE_LITERAL(font, BOX_OPAQUE_TAG_FONT);
+			Toy_setLiteralDictionary(&cache->fonts, keyLiteral, fontLiteral);
+			Toy_freeLiteral(fontLiteral);
+		}
+	}
+
+	Toy_freeLiteral(keyLiteral);
+
+	return font;
+}
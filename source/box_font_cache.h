@@ -0,0 +1,19 @@
+#pragma once
+
+#include "box_common.h"
+
+#include "toy_literal.h"
+#include "toy_literal_dictionary.h"
+
+//NOTE: only used internally, never exposed to scripts
+#define BOX_OPAQUE_TAG_FONT 1003
+
+//open fonts, keyed by their resolved drive path and point size
+typedef struct Box_private_font_cache {
+	Toy_LiteralDictionary fonts; //"size:path" -> opaque font
+} Box_FontCache;
+
+BOX_API void Box_initFontCache(Box_FontCache* cache);
+BOX_API void Box_freeFontCache(Box_FontCache* cache); //NOTE: must be called before TTF_Quit()
+
+BOX_API TTF_Font* Box_loadFontCache(Box_FontCache* cache, Toy_Literal filePathLiteral, int pointSize); //owned by the cache, or NULL on error
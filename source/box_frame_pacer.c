@@ -0,0 +1,54 @@
+#include "box_frame_pacer.h"
+
+//exposed functions
+void Box_initFramePacer(Box_FramePacer* pacer, int targetFPS) {
+	pacer->frequency = SDL_GetPerformanceFrequency();
+	pacer->spinTicks = pacer->frequency * BOX_PACER_SPIN_MICROSECONDS / 1000000;
+	pacer->vsync = false;
+	pacer->missedFrames = 0;
+
+	Box_setTargetFramePacer(pacer, targetFPS);
+}
+
+void Box_setTargetFramePacer(Box_FramePacer* pacer, int targetFPS) {
+	pacer->frameTicks = targetFPS > 0 ? pacer->frequency / targetFPS : 0;
+	pacer->deadline = 0; //restart the schedule
+}
+
+void Box_waitFramePacer(Box_FramePacer* pacer) {
+	//uncapped
+	if (pacer->frameTicks == 0) {
+		return;
+	}
+
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	if (pacer->deadline == 0) {
+		pacer->deadline = now + pacer->frameTicks;
+	}
+
+	//too late - don't try to catch up, or the next frames would be rushed
+	if (now > pacer->deadline) {
+		pacer->missedFrames++;
+		pacer->deadline = now + pacer->frameTicks;
+		return;
+	}
+
+	//sleep for most of the remaining time, then spin for the rest
+	Uint64 remaining = pacer->deadline - now;
+
+	if (remaining > pacer->spinTicks) {
+		SDL_Delay((Uint32)((remaining - pacer->spinTicks) * 1000 / pacer->frequency));
+	}
+
+	while (SDL_GetPerformanceCounter() < pacer->deadline) {
+		//spin
+	}
+
+	//keep a steady cadence, independent of how long this frame took
+	pacer->deadline += pacer->frameTicks;
+}
+
+int Box_getMissedFramesFramePacer(Box_FramePacer* pacer) {
+	return pacer->missedFrames;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "box_common.h"
+
+//the default frame rate cap
+#define BOX_DEFAULT_TARGET_FPS 60
+
+//sleeping is imprecise, so spin for the last part of each frame
+#define BOX_PACER_SPIN_MICROSECONDS 2000
+
+//keeps frames evenly spaced, using the high-resolution clock
+typedef struct Box_private_frame_pacer {
+	Uint64 frequency; //clock ticks per second
+	Uint64 frameTicks; //target frame length, or 0 when uncapped
+	Uint64 spinTicks;
+	Uint64 deadline; //when the current frame should end, or 0 before the first frame
+
+	bool vsync; //let the renderer's present wait for the display
+
+	//statistics
+	int missedFrames; //frames which ended after their deadline
+} Box_FramePacer;
+
+BOX_API void Box_initFramePacer(Box_FramePacer* pacer, int targetFPS);
+
+BOX_API void Box_setTargetFramePacer(Box_FramePacer* pacer, int targetFPS); //0 means uncapped
+BOX_API void Box_waitFramePacer(Box_FramePacer* pacer); //call once per frame, after presenting
+
+BOX_API int Box_getMissedFramesFramePacer(Box_FramePacer* pacer);
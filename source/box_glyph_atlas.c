@@ -0,0 +1,182 @@
+#include "box_glyph_atlas.h"
+
+#include "toy_memory.h"
+
+//utils
+static Box_Glyph* getGlyphUtil(Box_GlyphAtlas* atlas, char c) {
+	if (c < BOX_GLYPH_FIRST || c >= BOX_GLYPH_FIRST + BOX_GLYPH_COUNT) {
+		c = '?';
+	}
+
+	return &atlas->glyphs[c - BOX_GLYPH_FIRST];
+}
+
+static Box_GlyphAtlas* buildAtlasUtil(SDL_Renderer* renderer, TTF_Font* font) {
+	SDL_Surface* surfaces[BOX_GLYPH_COUNT];
+	SDL_Color white = { 255, 255, 255, 255 };
+
+	Box_GlyphAtlas* atlas = TOY_ALLOCATE(Box_GlyphAtlas, 1);
+	atlas->font = font;
+	atlas->texture = NULL;
+	atlas->lineHeight = TTF_FontHeight(font);
+
+	//rasterize each glyph, and lay them out in rows
+	int x = 0;
+	int y = 0;
+
+	for (int i = 0; i < BOX_GLYPH_COUNT; i++) {
+		Box_Glyph* glyph = &atlas->glyphs[i];
+
+		surfaces[i] = TTF_RenderGlyph_Blended(font, (Uint16)(BOX_GLYPH_FIRST + i), white);
+
+		int advance = 0;
+		TTF_GlyphMetrics(font, (Uint16)(BOX_GLYPH_FIRST + i), NULL, NULL, NULL, NULL, &advance);
+		glyph->advance = advance;
+
+		if (surfaces[i] == NULL) {
+			glyph->region = (SDL_Rect){ 0, 0, 0, 0 };
+			continue;
+		}
+
+		if (x + surfaces[i]->w > BOX_GLYPH_ATLAS_WIDTH) {
+			x = 0;
+			y += atlas->lineHeight + 1;
+		}
+
+		glyph->region = (SDL_Rect){ x, y, surfaces[i]->w, surfaces[i]->h };
+		x += surfaces[i]->w + 1;
+	}
+
+	//copy them into one surface, then upload it once
+	SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, BOX_GLYPH_ATLAS_WIDTH, y + atlas->lineHeight, 32, SDL_PIXELFORMAT_RGBA32);
+
+	for (int i = 0; i < BOX_GLYPH_COUNT; i++) {
+		if (surfaces[i] == NULL) {
+			continue;
+		}
+
+		if (sheet != NULL) {
+			SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(surfaces[i], NULL, sheet, &atlas->glyphs[i].region);
+		}
+
+		SDL_FreeSurface(surfaces[i]);
+	}
+
+	if (sheet != NULL) {
+		atlas->texture = SDL_CreateTextureFromSurface(renderer, sheet);
+		SDL_FreeSurface(sheet);
+	}
+
+	if (atlas->texture == NULL) {
+		TOY_FREE(Box_GlyphAtlas, atlas);
+		return NULL;
+	}
+
+	SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+
+	return atlas;
+}
+
+//exposed functions
+void Box_initGlyphCache(Box_GlyphCache* cache) {
+	cache->atlases = NULL;
+	cache->capacity = 0;
+	cache->count = 0;
+}
+
+void Box_freeGlyphCache(Box_GlyphCache* cache) {
+	for (int i = 0; i < cache->count; i++) {
+		SDL_DestroyTexture(cache->atlases[i]->texture);
+		TOY_FREE(Box_GlyphAtlas, cache->atlases[i]);
+	}
+
+	TOY_FREE_ARRAY(Box_GlyphAtlas*, cache->atlases, cache->capacity);
+
+	Box_initGlyphCache(cache);
+}
+
+Box_GlyphAtlas* Box_loadGlyphCache(Box_GlyphCache* cache, SDL_Renderer* renderer, TTF_Font* font) {
+	//there are only ever a handful of fonts
+	for (int i = 0; i < cache->count; i++) {
+		if (cache->atlases[i]->font == font) {
+			return cache->atlases[i];
+		}
+	}
+
+	Box_GlyphAtlas* atlas = buildAtlasUtil(renderer, font);
+
+	if (atlas == NULL) {
+		return NULL;
+	}
+
+	if (cache->count + 1 > cache->capacity) {
+		int oldCapacity = cache->capacity;
+
+		cache->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		cache->atlases = TOY_GROW_ARRAY(Box_GlyphAtlas*, cache->atlases, oldCapacity, cache->capacity);
+	}
+
+	cache->atlases[cache->count++] = atlas;
+
+	return atlas;
+}
+
+void Box_measureGlyphAtlas(Box_GlyphAtlas* atlas, const char* text, int* width, int* height) {
+	int lineWidth = 0;
+	*width = 0;
+	*height = atlas->lineHeight;
+
+	for (const char* c = text; *c; c++) {
+		if (*c == '\n') {
+			lineWidth = 0;
+			*height += atlas->lineHeight;
+			continue;
+		}
+
+		lineWidth += getGlyphUtil(atlas, *c)->advance;
+
+		if (*width < lineWidth) {
+			*width = lineWidth;
+		}
+	}
+}
+
+void Box_drawGlyphAtlas(Box_GlyphAtlas* atlas, Box_SpriteBatch* batch, const char* text, SDL_Rect dest, int layer, SDL_Color color) {
+	int width, height;
+	Box_measureGlyphAtlas(atlas, text, &width, &height);
+
+	if (width == 0) {
+		return;
+	}
+
+	float scaleX = (float)dest.w / width;
+	float scaleY = (float)dest.h / height;
+
+	//the pen position, in unscaled pixels
+	int penX = 0;
+	int penY = 0;
+
+	for (const char* c = text; *c; c++) {
+		if (*c == '\n') {
+			penX = 0;
+			penY += atlas->lineHeight;
+			continue;
+		}
+
+		Box_Glyph* glyph = getGlyphUtil(atlas, *c);
+
+		if (glyph->region.w > 0 && *c != ' ') {
+			SDL_Rect quad = {
+				dest.x + (int)(penX * scaleX),
+				dest.y + (int)(penY * scaleY),
+				(int)(glyph->region.w * scaleX),
+				(int)(glyph->region.h * scaleY)
+			};
+
+			Box_pushTintedSpriteBatch(batch, atlas->texture, glyph->region, quad, layer, color);
+		}
+
+		penX += glyph->advance;
+	}
+}
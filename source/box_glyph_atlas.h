@@ -0,0 +1,38 @@
+#pragma once
+
+#include "box_common.h"
+#include "box_sprite_batch.h"
+
+//printable ASCII, anything else is drawn as '?'
+#define BOX_GLYPH_FIRST 32
+#define BOX_GLYPH_COUNT 95
+
+#define BOX_GLYPH_ATLAS_WIDTH 512
+
+typedef struct Box_private_glyph {
+	SDL_Rect region; //within the atlas texture, a full line high
+	int advance;
+} Box_Glyph;
+
+//every glyph of one font, rasterized once into a single texture
+typedef struct Box_private_glyph_atlas {
+	TTF_Font* font;
+	SDL_Texture* texture;
+	Box_Glyph glyphs[BOX_GLYPH_COUNT];
+	int lineHeight;
+} Box_GlyphAtlas;
+
+//the glyph atlases, one per font
+typedef struct Box_private_glyph_cache {
+	Box_GlyphAtlas** atlases;
+	int capacity;
+	int count;
+} Box_GlyphCache;
+
+BOX_API void Box_initGlyphCache(Box_GlyphCache* cache);
+BOX_API void Box_freeGlyphCache(Box_GlyphCache* cache);
+
+BOX_API Box_GlyphAtlas* Box_loadGlyphCache(Box_GlyphCache* cache, SDL_Renderer* renderer, TTF_Font* font); //owned by the cache, or NULL on error
+
+BOX_API void Box_measureGlyphAtlas(Box_GlyphAtlas* atlas, const char* text, int* width, int* height);
+BOX_API void Box_drawGlyphAtlas(Box_GlyphAtlas* atlas, Box_SpriteBatch* batch, const char* text, SDL_Rect dest, int layer, SDL_Color color); //the text is stretched to fit dest
@@ -0,0 +1,310 @@
+#include "box_loader.h"
+#include "box_pack.h"
+#include "box_file_view.h"
+
+#include "drive_system.h"
+
+#include "toy_memory.h"
+#include "toy_console_colors.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//utils
+static char* copyStringUtil(const char* str, size_t length) {
+	char* buffer = TOY_ALLOCATE(char, length + 1);
+	memcpy(buffer, str, length);
+	buffer[length] = '\0';
+	return buffer;
+}
+
+static void freeStringUtil(char* str) {
+	TOY_FREE_ARRAY(char, str, strlen(str) + 1);
+}
+
+static void pushJobUtil(Box_Loader* loader, const char* path) {
+	//each file is only compiled once per load
+	for (int i = 0; i < loader->count; i++) {
+		if (strcmp(loader->jobs[i].path, path) == 0) {
+			return;
+		}
+	}
+
+	if (loader->count + 1 > loader->capacity) {
+		int oldCapacity = loader->capacity;
+
+		loader->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		loader->jobs = TOY_GROW_ARRAY(Box_LoaderJob, loader->jobs, oldCapacity, loader->capacity);
+	}
+
+	Box_LoaderJob* job = &loader->jobs[loader->count++];
+
+	job->path = copyStringUtil(path, strlen(path));
+	job->bytecode = NULL;
+	job->size = 0;
+	job->modified = 0;
+	job->fileSize = 0;
+	job->done = false;
+	job->collected = false;
+}
+
+static void pushDiscoveredUtil(Box_Loader* loader, const char* str, size_t length) {
+	if (loader->discoveredCount + 1 > loader->discoveredCapacity) {
+		int oldCapacity = loader->discoveredCapacity;
+
+		loader->discoveredCapacity = TOY_GROW_CAPACITY(oldCapacity);
+		loader->discovered = TOY_GROW_ARRAY(char*, loader->discovered, oldCapacity, loader->discoveredCapacity);
+	}
+
+	loader->discovered[loader->discoveredCount++] = copyStringUtil(str, length);
+}
+
+static void clearJobsUtil(Box_Loader* loader) {
+	for (int i = 0; i < loader->count; i++) {
+		freeStringUtil(loader->jobs[i].path);
+
+		if (loader->jobs[i].bytecode != NULL) {
+			TOY_FREE_ARRAY(unsigned char, loader->jobs[i].bytecode, loader->jobs[i].size);
+		}
+	}
+
+	for (int i = 0; i < loader->discoveredCount; i++) {
+		freeStringUtil(loader->discovered[i]);
+	}
+
+	loader->count = 0;
+	loader->next = 0;
+	loader->done = 0;
+	loader->discoveredCount = 0;
+	loader->generation++;
+}
+
+//find the child scripts a file is likely to load, such as "scripts:/child.toy" - works on source and precompiled bytecode alike
+static void scanScriptUtil(Box_Loader* loader, const unsigned char* data, size_t size, int generation) {
+	for (size_t i = 1; i + 1 < size; i++) {
+		if (data[i] != ':' || data[i + 1] != '/') {
+			continue;
+		}
+
+		//the drive name is an identifier
+		size_t start = i;
+		while (start > 0 && (isalnum(data[start - 1]) || data[start - 1] == '_')) {
+			start--;
+		}
+
+		//the path runs until a quote, a space, or anything unprintable
+		size_t end = i + 2;
+		while (end < size && data[end] > ' ' && data[end] < 0x7F && data[end] != '"') {
+			end++;
+		}
+
+		if (start < i && end - start > 4 && memcmp(data + end - 4, ".toy", 4) == 0) {
+			SDL_LockMutex(loader->mutex);
+			if (generation == loader->generation) {
+				pushDiscoveredUtil(loader, (const char*)data + start, end - start);
+			}
+			SDL_UnlockMutex(loader->mutex);
+		}
+
+		i = end;
+	}
+}
+
+static int loaderThreadUtil(void* data) {
+	Box_Loader* loader = (Box_Loader*)data;
+
+	SDL_LockMutex(loader->mutex);
+
+	while (true) {
+		while (!loader->quit && loader->next >= loader->count) {
+			SDL_CondWait(loader->wake, loader->mutex);
+		}
+
+		if (loader->quit) {
+			break;
+		}
+
+		//take a private copy of the job, as the array can change while unlocked
+		int index = loader->next++;
+		int generation = loader->generation;
+		char* path = copyStringUtil(loader->jobs[index].path, strlen(loader->jobs[index].path));
+
+		SDL_UnlockMutex(loader->mutex);
+
+		//record the state of the file before reading it, like the cache does
+		time_t modified = 0;
+		long long fileSize = 0;
+		Box_FileView view;
+		const unsigned char* tb = NULL;
+		size_t size = 0;
+
+		if (!Box_statFilePack(path, &modified, &fileSize)) {
+			fprintf(stderr, TOY_CC_ERROR "Could not open file \"%s\"\n" TOY_CC_RESET, path);
+		}
+		else if (Box_openFileView(&view, path) == 0) {
+			scanScriptUtil(loader, view.data, view.size, generation);
+			tb = Box_compileViewBytecodeCache(&view, path, &size);
+
+			Box_closeFileView(&view);
+		}
+
+		freeStringUtil(path);
+
+		SDL_LockMutex(loader->mutex);
+
+		if (generation != loader->generation) {
+			//the load was abandoned while compiling
+			if (tb != NULL) {
+				TOY_FREE_ARRAY(unsigned char, (unsigned char*)tb, size);
+			}
+			continue;
+		}
+
+		Box_LoaderJob* job = &loader->jobs[index];
+
+		job->bytecode = (unsigned char*)tb;
+		job->size = tb != NULL ? size : 0;
+		job->modified = modified;
+		job->fileSize = fileSize;
+		job->done = true;
+		loader->done++;
+	}
+
+	SDL_UnlockMutex(loader->mutex);
+
+	return 0;
+}
+
+//exposed functions
+void Box_initLoader(Box_Loader* loader) {
+	loader->jobs = NULL;
+	loader->capacity = 0;
+	loader->count = 0;
+	loader->next = 0;
+	loader->done = 0;
+	loader->discovered = NULL;
+	loader->discoveredCapacity = 0;
+	loader->discoveredCount = 0;
+	loader->generation = 0;
+	loader->quit = false;
+
+	loader->mutex = SDL_CreateMutex();
+	loader->wake = SDL_CreateCond();
+	loader->thread = SDL_CreateThread(loaderThreadUtil, "Box_Loader", loader);
+
+	if (loader->thread == NULL) {
+		fprintf(stderr, TOY_CC_ERROR "Could not start the loader thread: %s\n" TOY_CC_RESET, SDL_GetError());
+	}
+}
+
+void Box_freeLoader(Box_Loader* loader) {
+	if (loader->thread != NULL) {
+		SDL_LockMutex(loader->mutex);
+		loader->quit = true;
+		SDL_CondSignal(loader->wake);
+		SDL_UnlockMutex(loader->mutex);
+
+		SDL_WaitThread(loader->thread, NULL);
+		loader->thread = NULL;
+	}
+
+	clearJobsUtil(loader);
+
+	TOY_FREE_ARRAY(Box_LoaderJob, loader->jobs, loader->capacity);
+	TOY_FREE_ARRAY(char*, loader->discovered, loader->discoveredCapacity);
+
+	SDL_DestroyCond(loader->wake);
+	SDL_DestroyMutex(loader->mutex);
+
+	loader->jobs = NULL;
+	loader->capacity = 0;
+	loader->discovered = NULL;
+	loader->discoveredCapacity = 0;
+}
+
+void Box_startLoader(Box_Loader* loader, Toy_Literal filePathLiteral) {
+	SDL_LockMutex(loader->mutex);
+
+	clearJobsUtil(loader);
+	pushJobUtil(loader, Toy_toCString(TOY_AS_STRING(filePathLiteral)));
+
+	SDL_CondSignal(loader->wake);
+	SDL_UnlockMutex(loader->mutex);
+}
+
+void Box_clearLoader(Box_Loader* loader) {
+	SDL_LockMutex(loader->mutex);
+	clearJobsUtil(loader);
+	SDL_UnlockMutex(loader->mutex);
+}
+
+bool Box_pollLoader(Box_Loader* loader, Toy_Interpreter* interpreter, Box_BytecodeCache* cache) {
+	SDL_LockMutex(loader->mutex);
+
+	//without a thread, leave everything to the synchronous load
+	if (loader->thread == NULL) {
+		for (int i = 0; i < loader->count; i++) {
+			if (!loader->jobs[i].done) {
+				loader->jobs[i].done = true;
+				loader->jobs[i].collected = true;
+				loader->done++;
+			}
+		}
+	}
+
+	//move the finished scripts into the cache
+	for (int i = 0; i < loader->count; i++) {
+		Box_LoaderJob* job = &loader->jobs[i];
+
+		if (!job->done || job->collected) {
+			continue;
+		}
+
+		job->collected = true;
+
+		//a failed compile is left for the synchronous load to report
+		if (job->bytecode != NULL) {
+			Toy_Literal pathLiteral = TOY_TO_STRING_LITERAL(Toy_createRefString(job->path));
+			Box_storeBytecodeCache(cache, pathLiteral, job->bytecode, job->size, job->modified, job->fileSize);
+			Toy_freeLiteral(pathLiteral);
+
+			job->bytecode = NULL; //owned by the cache now
+		}
+	}
+
+	//queue the scripts found along the way, unless they're already cached
+	for (int i = 0; i < loader->discoveredCount; i++) {
+		Toy_Literal drivePathLiteral = TOY_TO_STRING_LITERAL(Toy_createRefString(loader->discovered[i]));
+		Toy_Literal filePathLiteral = Toy_getDrivePathLiteral(interpreter, &drivePathLiteral);
+
+		if (TOY_IS_STRING(filePathLiteral) && !Box_isFreshBytecodeCache(cache, filePathLiteral)) {
+			pushJobUtil(loader, Toy_toCString(TOY_AS_STRING(filePathLiteral)));
+		}
+
+		Toy_freeLiteral(drivePathLiteral);
+		Toy_freeLiteral(filePathLiteral);
+		freeStringUtil(loader->discovered[i]);
+	}
+
+	loader->discoveredCount = 0;
+
+	bool ready = loader->done >= loader->count;
+
+	if (!ready) {
+		SDL_CondSignal(loader->wake);
+	}
+
+	SDL_UnlockMutex(loader->mutex);
+
+	return ready;
+}
+
+float Box_getProgressLoader(Box_Loader* loader) {
+	SDL_LockMutex(loader->mutex);
+	float progress = loader->count > 0 ? (float)loader->done / loader->count : 1.0f;
+	SDL_UnlockMutex(loader->mutex);
+
+	return progress;
+}
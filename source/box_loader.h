@@ -0,0 +1,51 @@
+#pragma once
+
+#include "box_common.h"
+#include "box_bytecode_cache.h"
+
+#include "toy_interpreter.h"
+
+#include <time.h>
+
+//a script compiled by the loader thread, waiting to be moved into the bytecode cache
+typedef struct Box_private_loader_job {
+	char* path; //resolved file path
+	unsigned char* bytecode; //NULL until compiled, or if compiling failed
+	size_t size;
+	time_t modified;
+	long long fileSize;
+	bool done;
+	bool collected;
+} Box_LoaderJob;
+
+//compiles a scene's scripts in the background, so the main loop can keep running
+typedef struct Box_private_loader {
+	SDL_Thread* thread;
+	SDL_mutex* mutex;
+	SDL_cond* wake;
+
+	//everything below is guarded by the mutex
+	Box_LoaderJob* jobs;
+	int capacity;
+	int count;
+	int next; //the next job the thread will take
+	int done;
+
+	//drive paths found in the compiled sources, resolved on the main thread (the drive system isn't thread-safe)
+	char** discovered;
+	int discoveredCapacity;
+	int discoveredCount;
+
+	int generation; //bumped when the jobs are discarded, so stale results are dropped
+	bool quit;
+} Box_Loader;
+
+BOX_API void Box_initLoader(Box_Loader* loader); //starts the thread
+BOX_API void Box_freeLoader(Box_Loader* loader); //waits for the current script, then stops the thread
+
+BOX_API void Box_startLoader(Box_Loader* loader, Toy_Literal filePathLiteral); //discards any unfinished work, then compiles the file and the scripts it refers to
+BOX_API void Box_clearLoader(Box_Loader* loader); //discards any unfinished work
+
+//called by the main thread every frame - moves the finished scripts into the cache, and returns true once everything is compiled
+BOX_API bool Box_pollLoader(Box_Loader* loader, Toy_Interpreter* interpreter, Box_BytecodeCache* cache);
+BOX_API float Box_getProgressLoader(Box_Loader* loader); //from 0 to 1, where 1 means idle (may go down as new scripts are found)
@@ -3,16 +3,159 @@
 
 #include "toy_memory.h"
 
+#include <string.h>
+
+//the names of the lifecycle hooks, in the same order as Box_LifecycleHook
+static const char* hookNames[BOX_HOOK_COUNT] = {
+	"onLoad",
+	"onInit",
+	"onFree",
+	"onFrameStart",
+	"onUpdate",
+	"onStep",
+	"onDraw",
+	"onFrameEnd",
+	"onKeyDown",
+	"onKeyUp",
+	"onMouseMotion",
+	"onMouseButtonDown",
+	"onMouseButtonUp",
+	"onMouseWheel",
+	"onInput",
+};
+
+//the local transform lives on the node, or in the engine's packed store
+#define TRANSFORM(node, field) (*((node)->transform < 0 ? &(node)->field : &engine.transforms.field[(node)->transform]))
+
+//invalidate the cached world transform of this node and its descendants
+static void markWorldDirtyRecursiveUtil(Box_Node* node) {
+	if (node->worldDirty) {
+		return; //the descendants are already dirty
+	}
+
+	node->worldDirty = true;
+
+	for (int i = 0; i < node->count; i++) {
+		if (node->children[i] != NULL) {
+			markWorldDirtyRecursiveUtil(node->children[i]);
+		}
+	}
+}
+
+static void markWorldDirtyUtil(Box_Node* node) {
+	markWorldDirtyRecursiveUtil(node);
+
+	//let the per-frame pass find this subtree
+	for (Box_Node* parent = node->parent; parent != NULL && !parent->worldChildDirty; parent = parent->parent) {
+		parent->worldChildDirty = true;
+	}
+}
+
+//recompute the cached world transform from the parent's
+static void updateWorldUtil(Box_Node* node) {
+	Box_Node* parent = node->parent;
+
+	if (parent != NULL) {
+		if (parent->worldDirty) {
+			updateWorldUtil(parent);
+		}
+
+		node->worldPositionX = parent->worldPositionX + TRANSFORM(node, positionX);
+		node->worldPositionY = parent->worldPositionY + TRANSFORM(node, positionY);
+		node->worldMotionX = parent->worldMotionX + TRANSFORM(node, motionX);
+		node->worldMotionY = parent->worldMotionY + TRANSFORM(node, motionY);
+		node->worldScaleX = parent->worldScaleX * TRANSFORM(node, scaleX);
+		node->worldScaleY = parent->worldScaleY * TRANSFORM(node, scaleY);
+	}
+	else {
+		node->worldPositionX = TRANSFORM(node, positionX);
+		node->worldPositionY = TRANSFORM(node, positionY);
+		node->worldMotionX = TRANSFORM(node, motionX);
+		node->worldMotionY = TRANSFORM(node, motionY);
+		node->worldScaleX = TRANSFORM(node, scaleX);
+		node->worldScaleY = TRANSFORM(node, scaleY);
+	}
+
+	node->worldDirty = false;
+
+	//the children are still dirty
+	if (node->count > 0) {
+		node->worldChildDirty = true;
+	}
+}
+
+Box_Node* Box_allocateNode() {
+	return Box_allocateNodePool(&engine.nodePool);
+}
+
+static void silentPrintUtil(const char* output) {
+	//NO-OP
+}
+
+//copy the functions from a scope which has just run a script
+static void collectFunctionsUtil(Box_FunctionTable* table, Toy_Scope* scope) {
+	Toy_LiteralDictionary* variablesPtr = &scope->variables;
+
+	for (int i = 0; i < variablesPtr->capacity; i++) {
+		//skip empties and tombstones
+		if (TOY_IS_NULL(variablesPtr->entries[i].key)) {
+			continue;
+		}
+
+		//if this variable is a function
+		Toy_private_dictionary_entry* entry = &variablesPtr->entries[i];
+		if (TOY_IS_FUNCTION(entry->value)) {
+			//save a copy
+			Toy_setLiteralDictionary(&table->functions, entry->key, entry->value);
+		}
+	}
+}
+
+//record which lifecycle hooks exist, so the others can be skipped
+static void updateHooksUtil(Box_FunctionTable* table) {
+	table->hooks = 0;
+
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		if (!Toy_existsLiteralDictionary(&table->functions, engine.hookKeys[i])) {
+			continue;
+		}
+
+		table->hooks |= BOX_HOOK_BIT(i);
+
+		//borrow the stored function, as a lookup would copy it - this runs again whenever the table changes
+		for (int j = 0; j < table->functions.capacity; j++) {
+			if (!TOY_IS_NULL(table->functions.entries[j].key) && Toy_literalsAreEqual(table->functions.entries[j].key, engine.hookKeys[i])) {
+				table->hookFns[i] = table->functions.entries[j].value;
+				break;
+			}
+		}
+	}
+}
+
 void Box_initNode(Box_Node* node, Toy_Interpreter* interpreter, const unsigned char* tb, size_t size) {
-	//init
+	Box_initSharedNode(node, interpreter, tb, size, NULL);
+}
+
+void Box_initSharedNode(Box_Node* node, Toy_Interpreter* interpreter, const unsigned char* tb, size_t size, Box_FunctionTable** shared) {
+	//init (the pool provides the children array)
 	node->scope = NULL;
-	node->functions = TOY_ALLOCATE(Toy_LiteralDictionary, 1);
+	node->functions = NULL;
+	node->hooks = 0;
+	node->mutedHooks = 0;
+	node->subscriptionCount = 0;
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		node->dispatchIndices[i] = -1;
+	}
+	node->script = NULL;
+	node->scriptIndex = -1;
 	node->parent = NULL;
-	node->children = NULL;
-	node->capacity = 0;
 	node->count = 0;
 	node->childCount = 0;
 	node->texture = NULL;
+	node->textureEntry = NULL;
+	node->text = NULL;
+	node->textFont = NULL;
+	node->glyphAtlas = NULL;
 	node->rect = ((SDL_Rect) { 0, 0, 0, 0 });
 	node->frames = 0;
 	node->currentFrame = 0;
@@ -23,8 +166,10 @@ void Box_initNode(Box_Node* node, Toy_Interpreter* interpreter, const unsigned c
 	node->scaleX = 1.0f;
 	node->scaleY = 1.0f;
 	node->layer = 0;
-
-	Toy_initLiteralDictionary(node->functions);
+	node->worldDirty = true;
+	node->worldChildDirty = false;
+	node->autoDraw = false;
+	node->transform = engine.packedTransforms ? Box_pushTransformStore(&engine.transforms, node) : -1;
 
 	//skip empty nodes
 	if (tb == NULL) {
@@ -34,21 +179,26 @@ void Box_initNode(Box_Node* node, Toy_Interpreter* interpreter, const unsigned c
 	//run bytecode
 	Toy_runInterpreter(interpreter, tb, size);
 
+	//hold the scope, so the functions can be called with it (NOT freed here)
+	node->scope = interpreter->scope;
+
+	//nodes from the same script can share one table
+	if (shared != NULL && *shared != NULL) {
+		node->functions = Box_retainFunctionTable(*shared);
+		node->hooks = node->functions->hooks;
+		return;
+	}
+
+	node->functions = Box_allocateFunctionTablePool(&engine.nodePool);
+
 	//grab all top-level functions from the dirty interpreter
-	Toy_LiteralDictionary* variablesPtr = &interpreter->scope->variables;
+	collectFunctionsUtil(node->functions, interpreter->scope);
 
-	for (int i = 0; i < variablesPtr->capacity; i++) {
-		//skip empties and tombstones
-		if (TOY_IS_NULL(variablesPtr->entries[i].key)) {
-			continue;
-		}
+	updateHooksUtil(node->functions);
+	node->hooks = node->functions->hooks;
 
-		//if this variable is a function
-		Toy_private_dictionary_entry* entry = &variablesPtr->entries[i];
-		if (TOY_IS_FUNCTION(entry->value)) {
-			//save a copy
-			Toy_setLiteralDictionary(node->functions, entry->key, entry->value);
-		}
+	if (shared != NULL) {
+		*shared = Box_retainFunctionTable(node->functions);
 	}
 }
 
@@ -66,9 +216,18 @@ void Box_pushNode(Box_Node* node, Box_Node* child) {
 
 	//reverse-assign
 	child->parent = node;
+	markWorldDirtyUtil(child);
 
 	//count
 	node->childCount++;
+
+	//the packed motion step only moves nodes within the tree
+	if (node->transform >= 0 && engine.transforms.attached[node->transform]) {
+		Box_attachTransformNode(child);
+	}
+
+	//keep the engine's dispatch lists in sync
+	Box_pushDispatcher(&engine.dispatcher, engine.rootNode, node, child);
 }
 
 void Box_freeNode(Box_Node* node) {
@@ -76,29 +235,37 @@ void Box_freeNode(Box_Node* node) {
 		return; //NO-OP
 	}
 
+	//remove this node from the engine's dispatch lists
+	Box_removeDispatcher(&engine.dispatcher, node);
+
+	//and from its script's list of live nodes
+	if (node->script != NULL) {
+		Box_untrackNodeBytecodeCache(node);
+	}
+
 	//free this node's children
 	for (int i = 0; i < node->count; i++) {
 		Box_freeNode(node->children[i]);
 	}
 
-	//free the pointer array to the children
-	TOY_FREE_ARRAY(Box_Node*, node->children, node->capacity);
+	if (node->scope != NULL) {
+		Toy_popScope(node->scope);
+	}
 
 	if (node->functions != NULL) {
-		Toy_freeLiteralDictionary(node->functions);
-		TOY_FREE(Toy_LiteralDictionary, node->functions);
+		Box_releaseFunctionTable(node->functions);
 	}
 
-	if (node->scope != NULL) {
-		Toy_popScope(node->scope);
+	if (node->transform >= 0) {
+		Box_removeTransformStore(&engine.transforms, node->transform);
 	}
 
-	if (node->texture != NULL) {
-		Box_freeTextureNode(node);
-	}
+	Box_freeTextureNode(node); //also frees any text
 
-	//free this node's memory
-	TOY_FREE(Box_Node, node);
+	Box_setAutoDrawNode(node, false);
+
+	//recycle this node's memory, including its children array
+	Box_releaseNodePool(&engine.nodePool, node);
 }
 
 Box_Node* Box_getChildNode(Box_Node* node, int index) {
@@ -229,6 +396,7 @@ BOX_API void Box_sortChildrenNode(Box_Node* node, Toy_Interpreter* interpreter,
 	//sort the children
 	if (!sorted) {
 		recursiveLiteralQuicksortUtil(interpreter, node->children, node->count, fnCompare);
+		Box_invalidateDispatcher(&engine.dispatcher); //the tree order has changed
 	}
 
 	//re-count the newly-sorted children
@@ -237,36 +405,76 @@ BOX_API void Box_sortChildrenNode(Box_Node* node, Toy_Interpreter* interpreter,
 	}
 }
 
-Toy_Literal Box_callNodeLiteral(Box_Node* node, Toy_Interpreter* interpreter, Toy_Literal key, Toy_LiteralArray* args) {
-	Toy_Literal ret = TOY_TO_NULL_LITERAL;
+//call a function literal with this node as the first argument
+static Toy_Literal callFnUtil(Box_Node* node, Toy_Interpreter* interpreter, Toy_Literal fn, Toy_LiteralArray* args) {
+	Toy_Literal n = TOY_TO_OPAQUE_LITERAL(node, BOX_OPAQUE_TAG_NODE);
 
-	//if this fn exists
-	if (Toy_existsLiteralDictionary(node->functions, key)) {
-		Toy_Literal fn = Toy_getLiteralDictionary(node->functions, key);
-		Toy_Literal n = TOY_TO_OPAQUE_LITERAL(node, BOX_OPAQUE_TAG_NODE);
+	//each nesting level reuses its own frame, so calls stop allocating once the frames have grown
+	Toy_LiteralArray localArguments;
+	Toy_LiteralArray localReturns;
+	Toy_LiteralArray* arguments = &localArguments;
+	Toy_LiteralArray* returns = &localReturns;
 
-		Toy_LiteralArray arguments;
-		Toy_LiteralArray returns;
-		Toy_initLiteralArray(&arguments);
-		Toy_initLiteralArray(&returns);
+	if (engine.callDepth < BOX_CALL_FRAME_DEPTH) {
+		arguments = &engine.callArguments[engine.callDepth];
+		returns = &engine.callReturns[engine.callDepth];
+	}
+	else {
+		Toy_initLiteralArray(arguments);
+		Toy_initLiteralArray(returns);
+	}
 
-		//feed the arguments in
-		Toy_pushLiteralArray(&arguments, n);
+	engine.callDepth++;
 
-		if (args) {
-			for (int i = 0; i < args->count; i++) {
-				Toy_pushLiteralArray(&arguments, args->literals[i]);
-			}
+	//feed the arguments in
+	Toy_pushLiteralArray(arguments, n);
+
+	if (args) {
+		for (int i = 0; i < args->count; i++) {
+			Toy_pushLiteralArray(arguments, args->literals[i]);
 		}
+	}
 
-		Toy_callLiteralFn(interpreter, fn, &arguments, &returns);
+	//the table may be shared, so bind the function to this node's scope for the call
+	void* fnScope = TOY_AS_FUNCTION(fn).scope;
+	TOY_AS_FUNCTION(fn).scope = node->scope;
 
-		ret = Toy_popLiteralArray(&returns);
+	Toy_callLiteralFn(interpreter, fn, arguments, returns);
 
-		Toy_freeLiteralArray(&arguments);
-		Toy_freeLiteralArray(&returns);
+	TOY_AS_FUNCTION(fn).scope = fnScope;
+
+	Toy_Literal ret = Toy_popLiteralArray(returns);
+
+	//leave the frame empty for the next call
+	while (arguments->count > 0) {
+		Toy_freeLiteral(Toy_popLiteralArray(arguments));
+	}
+
+	while (returns->count > 0) {
+		Toy_freeLiteral(Toy_popLiteralArray(returns));
+	}
+
+	engine.callDepth--;
+
+	if (arguments == &localArguments) {
+		Toy_freeLiteralArray(arguments);
+		Toy_freeLiteralArray(returns);
+	}
+
+	Toy_freeLiteral(n);
+
+	return ret;
+}
+
+Toy_Literal Box_callNodeLiteral(Box_Node* node, Toy_Interpreter* interpreter, Toy_Literal key, Toy_LiteralArray* args) {
+	Toy_Literal ret = TOY_TO_NULL_LITERAL;
+
+	//if this fn exists
+	if (node->functions != NULL && Toy_existsLiteralDictionary(&node->functions->functions, key)) {
+		Toy_Literal fn = Toy_getLiteralDictionary(&node->functions->functions, key);
+
+		ret = callFnUtil(node, interpreter, fn, args);
 
-		Toy_freeLiteral(n);
 		Toy_freeLiteral(fn);
 	}
 
@@ -286,30 +494,11 @@ Toy_Literal Box_callNode(Box_Node* node, Toy_Interpreter* interpreter, const cha
 
 void Box_callRecursiveNodeLiteral(Box_Node* node, Toy_Interpreter* interpreter, Toy_Literal key, Toy_LiteralArray* args) {
 	//if this fn exists
-	if (Toy_existsLiteralDictionary(node->functions, key)) {
-		Toy_Literal fn = Toy_getLiteralDictionary(node->functions, key);
-		Toy_Literal n = TOY_TO_OPAQUE_LITERAL(node, BOX_OPAQUE_TAG_NODE);
+	if (node->functions != NULL && Toy_existsLiteralDictionary(&node->functions->functions, key)) {
+		Toy_Literal fn = Toy_getLiteralDictionary(&node->functions->functions, key);
 
-		Toy_LiteralArray arguments;
-		Toy_LiteralArray returns;
-		Toy_initLiteralArray(&arguments);
-		Toy_initLiteralArray(&returns);
+		Toy_freeLiteral(callFnUtil(node, interpreter, fn, args));
 
-		//feed the arguments in
-		Toy_pushLiteralArray(&arguments, n);
-
-		if (args) {
-			for (int i = 0; i < args->count; i++) {
-				Toy_pushLiteralArray(&arguments, args->literals[i]);
-			}
-		}
-
-		Toy_callLiteralFn(interpreter, fn, &arguments, &returns);
-
-		Toy_freeLiteralArray(&arguments);
-		Toy_freeLiteralArray(&returns);
-
-		Toy_freeLiteral(n);
 		Toy_freeLiteral(fn);
 	}
 
@@ -330,6 +519,176 @@ void Box_callRecursiveNode(Box_Node* node, Toy_Interpreter* interpreter, const c
 	Toy_freeLiteral(key);
 }
 
+const char* Box_getHookName(Box_LifecycleHook hook) {
+	return hookNames[hook];
+}
+
+Toy_Literal Box_callNodeHook(Box_Node* node, Toy_Interpreter* interpreter, Box_LifecycleHook hook, Toy_LiteralArray* args) {
+	//skip nodes without this hook
+	if (!(node->hooks & BOX_HOOK_BIT(hook))) {
+		return TOY_TO_NULL_LITERAL;
+	}
+
+	//the function is borrowed, so hold the table in case the node is freed or changed during the call
+	Box_FunctionTable* table = Box_retainFunctionTable(node->functions);
+	Toy_Literal ret = callFnUtil(node, interpreter, table->hookFns[hook], args);
+	Box_releaseFunctionTable(table);
+
+	return ret;
+}
+
+void Box_callRecursiveNodeHook(Box_Node* node, Toy_Interpreter* interpreter, Box_LifecycleHook hook, Toy_LiteralArray* args) {
+	Toy_freeLiteral(Box_callNodeHook(node, interpreter, hook, args));
+
+	//recurse to the (non-tombstone) children
+	for (int i = 0; i < node->count; i++) {
+		if (node->children[i] != NULL) {
+			Box_callRecursiveNodeHook(node->children[i], interpreter, hook, args);
+		}
+	}
+}
+
+Box_FunctionTable* Box_retainFunctionTable(Box_FunctionTable* table) {
+	table->refCount++;
+	return table;
+}
+
+void Box_releaseFunctionTable(Box_FunctionTable* table) {
+	if (--table->refCount == 0) {
+		Box_releaseFunctionTablePool(&engine.nodePool, table);
+	}
+}
+
+void Box_setFunctionNode(Box_Node* node, Toy_Literal key, Toy_Literal fn) {
+	//copy-on-write
+	if (node->functions == NULL || node->functions->refCount > 1) {
+		Box_FunctionTable* table = Box_allocateFunctionTablePool(&engine.nodePool);
+
+		if (node->functions != NULL) {
+			for (int i = 0; i < node->functions->functions.capacity; i++) {
+				Toy_private_dictionary_entry* entry = &node->functions->functions.entries[i];
+
+				if (!TOY_IS_NULL(entry->key)) {
+					Toy_setLiteralDictionary(&table->functions, entry->key, entry->value);
+				}
+			}
+
+			Box_releaseFunctionTable(node->functions);
+		}
+
+		node->functions = table;
+	}
+
+	Toy_setLiteralDictionary(&node->functions->functions, key, fn);
+
+	updateHooksUtil(node->functions);
+
+	//the dispatch lists depend on the hooks
+	if (node->hooks != node->functions->hooks) {
+		node->hooks = node->functions->hooks;
+		Box_invalidateDispatcher(&engine.dispatcher);
+	}
+}
+
+Box_FunctionTable* Box_runFunctionTable(Toy_Interpreter* interpreter, const unsigned char* tb, size_t size, Toy_Scope** scopeOut) {
+	//a throwaway interpreter, detached from the global scope so the top level can't change any state
+	Toy_Interpreter inner;
+
+	//init the inner interpreter manually
+	Toy_initLiteralArray(&inner.literalCache);
+	Toy_initLiteralArray(&inner.stack);
+	inner.hooks = interpreter->hooks; //so the imports still work
+	inner.scope = Toy_pushScope(NULL);
+	inner.bytecode = tb;
+	inner.length = (int)size;
+	inner.count = 0;
+	inner.codeStart = -1;
+	inner.depth = interpreter->depth + 1;
+	inner.panic = false;
+	Toy_setInterpreterPrint(&inner, silentPrintUtil); //the top level already printed on the first load
+	Toy_setInterpreterAssert(&inner, interpreter->assertOutput);
+	Toy_setInterpreterError(&inner, interpreter->errorOutput);
+
+	Toy_runInterpreter(&inner, tb, size);
+
+	Box_FunctionTable* table = Box_allocateFunctionTablePool(&engine.nodePool);
+	collectFunctionsUtil(table, inner.scope);
+	updateHooksUtil(table);
+
+	//manual cleanup
+	Toy_freeLiteralArray(&inner.stack);
+	Toy_freeLiteralArray(&inner.literalCache);
+
+	*scopeOut = inner.scope;
+
+	return table;
+}
+
+void Box_swapFunctionsNode(Box_Node* node, Box_FunctionTable* previous, Box_FunctionTable* table, Toy_Scope* scope) {
+	if (node->functions == previous || node->functions == NULL) {
+		//still shared, so just move to the new table
+		if (node->functions != NULL) {
+			Box_releaseFunctionTable(node->functions);
+		}
+
+		node->functions = Box_retainFunctionTable(table);
+	}
+	else {
+		//changed at runtime, so patch the private copy: functions dropped from the script go, the rest are overwritten
+		if (previous != NULL) {
+			for (int i = 0; i < previous->functions.capacity; i++) {
+				Toy_Literal key = previous->functions.entries[i].key;
+
+				if (!TOY_IS_NULL(key) && !Toy_existsLiteralDictionary(&table->functions, key)) {
+					Toy_removeLiteralDictionary(&node->functions->functions, key);
+				}
+			}
+		}
+
+		for (int i = 0; i < table->functions.capacity; i++) {
+			Toy_private_dictionary_entry* entry = &table->functions.entries[i];
+
+			if (!TOY_IS_NULL(entry->key)) {
+				Toy_setLiteralDictionary(&node->functions->functions, entry->key, entry->value);
+			}
+		}
+
+		updateHooksUtil(node->functions);
+	}
+
+	//the functions look each other up by name through the node's scope, so that needs the new ones too
+	if (node->scope != NULL) {
+		for (int i = 0; i < scope->variables.capacity; i++) {
+			Toy_private_dictionary_entry* entry = &scope->variables.entries[i];
+
+			if (TOY_IS_NULL(entry->key)) {
+				continue;
+			}
+
+			//existing variables keep their state
+			bool declared = Toy_existsLiteralDictionary(&node->scope->variables, entry->key);
+
+			if (declared && !TOY_IS_FUNCTION(entry->value)) {
+				continue;
+			}
+
+			if (!declared) {
+				Toy_Literal type = Toy_getLiteralDictionary(&scope->types, entry->key);
+				Toy_declareScopeVariable(node->scope, entry->key, type);
+				Toy_freeLiteral(type);
+			}
+
+			Toy_setScopeVariable(node->scope, entry->key, entry->value, false);
+		}
+	}
+
+	//the dispatch lists depend on the hooks
+	if (node->hooks != node->functions->hooks) {
+		node->hooks = node->functions->hooks;
+		Box_invalidateDispatcher(&engine.dispatcher);
+	}
+}
+
 int Box_getChildCountNode(Box_Node* node) {
 	return node->childCount;
 }
@@ -352,23 +711,19 @@ BOX_API int Box_createTextureNode(Box_Node* node, int width, int height) {
 }
 
 int Box_loadTextureNode(Box_Node* node, const char* fname) {
-	SDL_Surface* surface = IMG_Load(fname);
+	Toy_Literal filePathLiteral = TOY_TO_STRING_LITERAL(Toy_createRefString(fname));
+	Box_TextureCacheEntry* entry = Box_loadTextureCache(&engine.textureCache, engine.renderer, filePathLiteral);
+	Toy_freeLiteral(filePathLiteral);
 
-	if (surface == NULL) {
+	if (entry == NULL) {
 		return -1;
 	}
 
-	node->texture = SDL_CreateTextureFromSurface(engine.renderer, surface);
-
-	if (node->texture == NULL) {
-		return -2;
-	}
+	node->texture = entry->texture;
+	node->textureEntry = entry;
 
-	SDL_FreeSurface(surface);
-
-	int w, h;
-	SDL_QueryTexture(node->texture, NULL, NULL, &w, &h);
-	SDL_Rect r = { 0, 0, w, h };
+	//the rect is relative to the image, wherever it is within the texture
+	SDL_Rect r = { 0, 0, entry->region.w, entry->region.h };
 	Box_setRectNode(node, r);
 	Box_setFramesNode(node, 1); //default
 
@@ -377,8 +732,27 @@ int Box_loadTextureNode(Box_Node* node, const char* fname) {
 
 void Box_freeTextureNode(Box_Node* node) {
 	if (node->texture != NULL) {
-		SDL_DestroyTexture(node->texture);
+		//queued sprites might still use this texture
+		if (engine.spriteBatch.count > 0) {
+			Box_flushSpriteBatch(&engine.spriteBatch, engine.renderer);
+		}
+
+		if (node->textureEntry != NULL) {
+			Box_releaseTextureCache(&engine.textureCache, node->textureEntry);
+		}
+		else {
+			SDL_DestroyTexture(node->texture);
+		}
+
 		node->texture = NULL;
+		node->textureEntry = NULL;
+	}
+
+	if (node->text != NULL) {
+		Toy_deleteRefString(node->text);
+		node->text = NULL;
+		node->textFont = NULL;
+		node->glyphAtlas = NULL;
 	}
 }
 
@@ -415,104 +789,145 @@ void Box_incrementCurrentFrame(Box_Node* node) {
 }
 
 void Box_setPositionXNode(Box_Node* node, int x) {
-	node->positionX = x;
+	if (TRANSFORM(node, positionX) != x) {
+		TRANSFORM(node, positionX) = x;
+		markWorldDirtyUtil(node);
+	}
 }
 
 void Box_setPositionYNode(Box_Node* node, int y) {
-	node->positionY = y;
+	if (TRANSFORM(node, positionY) != y) {
+		TRANSFORM(node, positionY) = y;
+		markWorldDirtyUtil(node);
+	}
 }
 
 void Box_setMotionXNode(Box_Node* node, int x) {
-	node->motionX = x;
+	if (TRANSFORM(node, motionX) != x) {
+		TRANSFORM(node, motionX) = x;
+		markWorldDirtyUtil(node);
+	}
 }
 void Box_setMotionYNode(Box_Node* node, int y) {
-	node->motionY = y;
+	if (TRANSFORM(node, motionY) != y) {
+		TRANSFORM(node, motionY) = y;
+		markWorldDirtyUtil(node);
+	}
 }
 
 void Box_setScaleXNode(Box_Node* node, float sx) {
-	node->scaleX = sx;
+	if (TRANSFORM(node, scaleX) != sx) {
+		TRANSFORM(node, scaleX) = sx;
+		markWorldDirtyUtil(node);
+	}
 }
 
 void Box_setScaleYNode(Box_Node* node, float sy) {
-	node->scaleY = sy;
+	if (TRANSFORM(node, scaleY) != sy) {
+		TRANSFORM(node, scaleY) = sy;
+		markWorldDirtyUtil(node);
+	}
 }
 
 int Box_getPositionXNode(Box_Node* node) {
-	return node->positionX;
+	return TRANSFORM(node, positionX);
 }
 
 int Box_getPositionYNode(Box_Node* node) {
-	return node->positionY;
+	return TRANSFORM(node, positionY);
 }
 
 int Box_getMotionXNode(Box_Node* node) {
-	return node->motionX;
+	return TRANSFORM(node, motionX);
 }
 
 int Box_getMotionYNode(Box_Node* node) {
-	return node->motionY;
+	return TRANSFORM(node, motionY);
 }
 
 float Box_getScaleXNode(Box_Node* node) {
-	return node->scaleX;
+	return TRANSFORM(node, scaleX);
 }
 
 float Box_getScaleYNode(Box_Node* node) {
-	return node->scaleY;
+	return TRANSFORM(node, scaleY);
 }
 
 int Box_getWorldPositionXNode(Box_Node* node) {
-	int result = 0;
-	while(node != NULL) {
-		result += node->positionX;
-		node = node->parent;
+	if (node->worldDirty) {
+		updateWorldUtil(node);
 	}
-	return result;
+	return node->worldPositionX;
 }
 
 int Box_getWorldPositionYNode(Box_Node* node) {
-	int result = 0;
-	while(node != NULL) {
-		result += node->positionY;
-		node = node->parent;
+	if (node->worldDirty) {
+		updateWorldUtil(node);
 	}
-	return result;
+	return node->worldPositionY;
 }
 
 int Box_getWorldMotionXNode(Box_Node* node) {
-	int result = 0;
-	while(node != NULL) {
-		result += node->motionX;
-		node = node->parent;
+	if (node->worldDirty) {
+		updateWorldUtil(node);
 	}
-	return result;
+	return node->worldMotionX;
 }
 
 int Box_getWorldMotionYNode(Box_Node* node) {
-	int result = 0;
-	while(node != NULL) {
-		result += node->motionY;
-		node = node->parent;
+	if (node->worldDirty) {
+		updateWorldUtil(node);
 	}
-	return result;
+	return node->worldMotionY;
 }
 
 float Box_getWorldScaleXNode(Box_Node* node) {
-	float result = 1;
-	while(node != NULL) {
-		result *= node->scaleX;
-		node = node->parent;
+	if (node->worldDirty) {
+		updateWorldUtil(node);
 	}
-	return result;
+	return node->worldScaleX;
 }
 
 float Box_getWorldScaleYNode(Box_Node* node) {
-	float result = 1;
-	while(node != NULL) {
-		result *= node->scaleY;
-		node = node->parent;
+	if (node->worldDirty) {
+		updateWorldUtil(node);
+	}
+	return node->worldScaleY;
+}
+
+void Box_attachTransformNode(Box_Node* node) {
+	if (node->transform >= 0) {
+		engine.transforms.attached[node->transform] = -1;
+	}
+
+	for (int i = 0; i < node->count; i++) {
+		if (node->children[i] != NULL) {
+			Box_attachTransformNode(node->children[i]);
+		}
+	}
+}
+
+void Box_invalidateWorldNode(Box_Node* node) {
+	markWorldDirtyUtil(node);
+}
+
+void Box_updateWorldRecursiveNode(Box_Node* node) {
+	if (node->worldDirty) {
+		updateWorldUtil(node);
+	}
+
+	//skip clean subtrees
+	if (!node->worldChildDirty) {
+		return;
+	}
+
+	node->worldChildDirty = false;
+
+	for (int i = 0; i < node->count; i++) {
+		if (node->children[i] != NULL && (node->children[i]->worldDirty || node->children[i]->worldChildDirty)) {
+			Box_updateWorldRecursiveNode(node->children[i]);
+		}
 	}
-	return result;
 }
 
 void Box_setLayerNode(Box_Node* node, int layer) {
@@ -524,8 +939,11 @@ int Box_getLayerNode(Box_Node* node) {
 }
 
 void Box_movePositionByMotionNode(Box_Node* node) {
-	node->positionX += node->motionX;
-	node->positionY += node->motionY;
+	if (TRANSFORM(node, motionX) != 0 || TRANSFORM(node, motionY) != 0) {
+		TRANSFORM(node, positionX) += TRANSFORM(node, motionX);
+		TRANSFORM(node, positionY) += TRANSFORM(node, motionY);
+		markWorldDirtyUtil(node);
+	}
 }
 
 void Box_movePositionByMotionRecursiveNode(Box_Node* node) {
@@ -540,9 +958,63 @@ void Box_movePositionByMotionRecursiveNode(Box_Node* node) {
 }
 
 void Box_setTextNode(Box_Node* node, TTF_Font* font, const char* text, SDL_Color color) {
-	SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
+	//switching from glyph text
+	if (node->glyphAtlas != NULL) {
+		Box_freeTextureNode(node);
+	}
+
+	//skip unchanged text
+	if (node->text != NULL && node->textFont == font && node->textColor.r == color.r && node->textColor.g == color.g && node->textColor.b == color.b && node->textColor.a == color.a && strcmp(Toy_toCString(node->text), text) == 0) {
+		return;
+	}
+
+	SDL_Surface* rendered = TTF_RenderText_Solid(font, text, color);
+
+	if (rendered == NULL) {
+		Box_freeTextureNode(node); //empty strings have no texture
+		return;
+	}
+
+	//in a fixed format, so the texture can be updated in place
+	SDL_Surface* surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(rendered);
+
+	if (surface == NULL) {
+		return;
+	}
+
+	//reuse the old text texture if it's the same size
+	int w = 0, h = 0;
+	if (node->text != NULL) {
+		SDL_QueryTexture(node->texture, NULL, NULL, &w, &h);
+	}
+
+	if (node->text != NULL && w == surface->w && h == surface->h) {
+		//queued sprites should show the old text
+		if (engine.spriteBatch.count > 0) {
+			Box_flushSpriteBatch(&engine.spriteBatch, engine.renderer);
+		}
+
+		Toy_deleteRefString(node->text);
+	}
+	else {
+		Box_freeTextureNode(node);
+
+		node->texture = SDL_CreateTexture(engine.renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, surface->w, surface->h);
+
+		if (node->texture == NULL) {
+			SDL_FreeSurface(surface);
+			return;
+		}
+
+		SDL_SetTextureBlendMode(node->texture, SDL_BLENDMODE_BLEND);
+	}
 
-	node->texture = SDL_CreateTextureFromSurface(engine.renderer, surface);
+	SDL_UpdateTexture(node->texture, NULL, surface->pixels, surface->pitch);
+
+	node->text = Toy_createRefString(text);
+	node->textFont = font;
+	node->textColor = color;
 
 	node->rect = (SDL_Rect){ .x = 0, .y = 0, .w = surface->w, .h = surface->h };
 	node->frames = 1;
@@ -552,9 +1024,77 @@ void Box_setTextNode(Box_Node* node, TTF_Font* font, const char* text, SDL_Color
 }
 
 
+void Box_setGlyphTextNode(Box_Node* node, Box_GlyphAtlas* atlas, const char* text, SDL_Color color) {
+	//switching from texture text, or an image
+	if (node->glyphAtlas == NULL) {
+		Box_freeTextureNode(node);
+	}
+
+	//no rasterizing, just swap the string
+	if (node->text != NULL) {
+		Toy_deleteRefString(node->text);
+	}
+
+	node->text = Toy_createRefString(text);
+	node->textFont = atlas->font;
+	node->textColor = color;
+	node->glyphAtlas = atlas;
+
+	int w, h;
+	Box_measureGlyphAtlas(atlas, text, &w, &h);
+
+	node->rect = (SDL_Rect){ .x = 0, .y = 0, .w = w, .h = h };
+	node->frames = 1;
+	node->currentFrame = 0;
+}
+
 void Box_drawNode(Box_Node* node, SDL_Rect dest) {
+	//glyph text is drawn as one quad per character
+	if (node->glyphAtlas != NULL) {
+		Box_drawGlyphAtlas(node->glyphAtlas, &engine.spriteBatch, Toy_toCString(node->text), dest, node->layer, node->textColor);
+		return;
+	}
+
 	if (!node->texture) return;
 	SDL_Rect src = node->rect;
 	src.x += src.w * node->currentFrame;
-	SDL_RenderCopy(engine.renderer, node->texture, &src, &dest);
+
+	//offset into a shared texture
+	if (node->textureEntry != NULL) {
+		src.x += node->textureEntry->region.x;
+		src.y += node->textureEntry->region.y;
+	}
+
+	Box_pushSpriteBatch(&engine.spriteBatch, node->texture, src, dest, node->layer);
+}
+
+void Box_setAutoDrawNode(Box_Node* node, bool autoDraw) {
+	if (node->autoDraw != autoDraw) {
+		node->autoDraw = autoDraw;
+		engine.autoDrawCount += autoDraw ? 1 : -1;
+	}
+}
+
+bool Box_getAutoDrawNode(Box_Node* node) {
+	return node->autoDraw;
+}
+
+void Box_autoDrawRecursiveNode(Box_Node* node) {
+	if (node->autoDraw && (node->texture != NULL || node->glyphAtlas != NULL)) {
+		SDL_Rect dest = {
+			Box_getWorldPositionXNode(node),
+			Box_getWorldPositionYNode(node),
+			(int)(node->rect.w * Box_getWorldScaleXNode(node)),
+			(int)(node->rect.h * Box_getWorldScaleYNode(node))
+		};
+
+		Box_drawNode(node, dest);
+	}
+
+	//recurse to the (non-tombstone) children
+	for (int i = 0; i < node->count; i++) {
+		if (node->children[i] != NULL) {
+			Box_autoDrawRecursiveNode(node->children[i]);
+		}
+	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "box_common.h"
+#include "box_texture_cache.h"
+#include "box_glyph_atlas.h"
 
 #include "toy_literal_dictionary.h"
 #include "toy_interpreter.h"
@@ -11,18 +13,58 @@
 //forward declare
 typedef struct Box_private_node Box_Node;
 
+//the lifecycle functions called by the engine, in no particular order
+typedef enum Box_LifecycleHook {
+	BOX_HOOK_ON_LOAD,
+	BOX_HOOK_ON_INIT,
+	BOX_HOOK_ON_FREE,
+	BOX_HOOK_ON_FRAME_START,
+	BOX_HOOK_ON_UPDATE,
+	BOX_HOOK_ON_STEP,
+	BOX_HOOK_ON_DRAW,
+	BOX_HOOK_ON_FRAME_END,
+	BOX_HOOK_ON_KEY_DOWN,
+	BOX_HOOK_ON_KEY_UP,
+	BOX_HOOK_ON_MOUSE_MOTION,
+	BOX_HOOK_ON_MOUSE_BUTTON_DOWN,
+	BOX_HOOK_ON_MOUSE_BUTTON_UP,
+	BOX_HOOK_ON_MOUSE_WHEEL,
+	BOX_HOOK_ON_INPUT, //the frame's input events in one array, after they're dispatched one by one
+	BOX_HOOK_COUNT, //MUST be last
+} Box_LifecycleHook;
+
+#define BOX_HOOK_BIT(hook) (1u << (hook))
+
+//the top-level functions of a script, shared read-only by every node loaded from it
+typedef struct Box_private_function_table {
+	Toy_LiteralDictionary functions;
+	unsigned int hooks; //bitmask of the lifecycle hooks found in functions
+	Toy_Literal hookFns[BOX_HOOK_COUNT]; //borrowed from functions without copying, only valid where hooks is set
+	int refCount; //copy-on-write: only modified in place while this is 1
+
+	struct Box_private_function_table* next; //used by the node pool
+} Box_FunctionTable;
+
 //the node object, which forms a tree
 typedef struct Box_private_node {
 	//BUGFIX: hold the node's root scope so it can be popped
 	Toy_Scope* scope; //used by nativeLoadNode
 
-	//toy functions, stored in a dict for flexibility
-	Toy_LiteralDictionary* functions;
+	//toy functions, stored in a dict for flexibility (NULL for empty nodes)
+	Box_FunctionTable* functions; //called with this node's scope, so the table can be shared
+	unsigned int hooks; //copied from functions, for fast access
+	unsigned int mutedHooks; //unsubscribed at runtime, so skipped by the engine's dispatch lists
+	int subscriptionCount; //custom events this node is subscribed to
+	int dispatchIndices[BOX_HOOK_COUNT]; //position in each of the engine's dispatch lists, checked before use as it can be stale
+
+	//the cached script this node was loaded from, for hot-reloading (NULL for empty nodes)
+	struct Box_private_bytecode_cache_entry* script;
+	int scriptIndex; //in the script's list of live nodes
 
 	//cache the parent pointer for fast access
 	Box_Node* parent;
 
-	//use Toy's memory model
+	//use Toy's memory model (the array is kept when the node is recycled)
 	Box_Node** children;
 	int capacity;
 	int count; //includes tombstones
@@ -30,6 +72,13 @@ typedef struct Box_private_node {
 
 	//rendering-specific features
 	SDL_Texture* texture;
+	Box_TextureCacheEntry* textureEntry; //set when the texture is shared through the engine's cache
+
+	//what the texture shows, if set by Box_setTextNode()
+	Toy_RefString* text;
+	TTF_Font* textFont;
+	SDL_Color textColor;
+	Box_GlyphAtlas* glyphAtlas; //if set, the text is drawn from the font's glyph atlas instead of the texture
 	SDL_Rect rect; //rendered rect
 	int frames; //horizontal-strip based animations
 	int currentFrame;
@@ -41,14 +90,30 @@ typedef struct Box_private_node {
 	int motionY;
 	float scaleX;
 	float scaleY;
+	int transform; //index into the engine's packed transforms, or -1 if the above are used
+
+	//cached world transform (only valid while worldDirty is false)
+	int worldPositionX;
+	int worldPositionY;
+	int worldMotionX;
+	int worldMotionY;
+	float worldScaleX;
+	float worldScaleY;
+	bool worldDirty; //if set, it's also set for every descendant
+	bool worldChildDirty; //a descendant might be dirty
 
 	//sorting layer
 	int layer;
+
+	//drawn by the engine every frame, without an onDraw() hook
+	bool autoDraw;
 } Box_Node;
 
+BOX_API Box_Node* Box_allocateNode(); //take a node from the engine's pool - nodes MUST be allocated this way
 BOX_API void Box_initNode(Box_Node* node, Toy_Interpreter* interpreter, const unsigned char* tb, size_t size); //run bytecode, then grab all top-level function literals
+BOX_API void Box_initSharedNode(Box_Node* node, Toy_Interpreter* interpreter, const unsigned char* tb, size_t size, Box_FunctionTable** shared); //as above, but reuse "*shared" if it exists, or fill it if it doesn't
 BOX_API void Box_pushNode(Box_Node* node, Box_Node* child); //push to the array (prune tombstones when expanding/copying)
-BOX_API void Box_freeNode(Box_Node* node); //free this node and all children
+BOX_API void Box_freeNode(Box_Node* node); //free this node and all children (returns them to the engine's pool)
 
 BOX_API Box_Node* Box_getChildNode(Box_Node* node, int index); //NOTE: indexes are no longer valid after sorting
 BOX_API void Box_freeChildNode(Box_Node* node, int index);
@@ -62,10 +127,25 @@ BOX_API Toy_Literal Box_callNode(Box_Node* node, Toy_Interpreter* interpreter, c
 BOX_API void Box_callRecursiveNodeLiteral(Box_Node* node, Toy_Interpreter* interpreter, Toy_Literal key, Toy_LiteralArray* args);
 BOX_API void Box_callRecursiveNode(Box_Node* node, Toy_Interpreter* interpreter, const char* fnName, Toy_LiteralArray* args); //call "fnName" on this node, and all children, if it exists
 
+//faster versions of the above, using the engine's interned keys - nodes without the hook are skipped without a lookup
+BOX_API const char* Box_getHookName(Box_LifecycleHook hook);
+BOX_API Toy_Literal Box_callNodeHook(Box_Node* node, Toy_Interpreter* interpreter, Box_LifecycleHook hook, Toy_LiteralArray* args);
+BOX_API void Box_callRecursiveNodeHook(Box_Node* node, Toy_Interpreter* interpreter, Box_LifecycleHook hook, Toy_LiteralArray* args);
+
+//function tables
+BOX_API Box_FunctionTable* Box_retainFunctionTable(Box_FunctionTable* table);
+BOX_API void Box_releaseFunctionTable(Box_FunctionTable* table); //returns the table to the engine's pool when no longer used
+BOX_API void Box_setFunctionNode(Box_Node* node, Toy_Literal key, Toy_Literal fn); //copies a shared table before modifying it
+
+//for hot-reloading
+BOX_API Box_FunctionTable* Box_runFunctionTable(Toy_Interpreter* interpreter, const unsigned char* tb, size_t size, Toy_Scope** scopeOut); //run bytecode without a node, and grab its top-level functions - the caller pops "*scopeOut"
+//NOTE: the top level runs again, in a scope of its own with printing silenced - but natives it calls, such as loads, still take effect
+BOX_API void Box_swapFunctionsNode(Box_Node* node, Box_FunctionTable* previous, Box_FunctionTable* table, Toy_Scope* scope); //replace the functions from "previous" in place, declaring any new top-level variables from "scope"
+
 BOX_API int Box_getChildCountNode(Box_Node* node);
 
 BOX_API int Box_createTextureNode(Box_Node* node, int width, int height);
-BOX_API int Box_loadTextureNode(Box_Node* node, const char* fname);
+BOX_API int Box_loadTextureNode(Box_Node* node, const char* fname); //shared with other nodes using the same file
 BOX_API void Box_freeTextureNode(Box_Node* node);
 
 BOX_API void Box_setRectNode(Box_Node* node, SDL_Rect rect);
@@ -99,6 +179,10 @@ BOX_API int Box_getWorldMotionYNode(Box_Node* node);
 BOX_API float Box_getWorldScaleXNode(Box_Node* node);
 BOX_API float Box_getWorldScaleYNode(Box_Node* node);
 
+BOX_API void Box_attachTransformNode(Box_Node* node); //mark this subtree as part of the engine's tree, so the packed motion step moves it
+BOX_API void Box_invalidateWorldNode(Box_Node* node); //mark the world transform of this node and its descendants as stale
+BOX_API void Box_updateWorldRecursiveNode(Box_Node* node); //recompute the dirty world transforms, called once per frame
+
 BOX_API void Box_movePositionByMotionNode(Box_Node* node);
 BOX_API void Box_movePositionByMotionRecursiveNode(Box_Node* node);
 
@@ -107,6 +191,11 @@ BOX_API void Box_setLayerNode(Box_Node* node, int layer);
 BOX_API int Box_getLayerNode(Box_Node* node);
 
 //utilities
-BOX_API void Box_setTextNode(Box_Node* node, TTF_Font* font, const char* text, SDL_Color color);
+BOX_API void Box_setTextNode(Box_Node* node, TTF_Font* font, const char* text, SDL_Color color); //does nothing if the text is unchanged
+BOX_API void Box_setGlyphTextNode(Box_Node* node, Box_GlyphAtlas* atlas, const char* text, SDL_Color color); //cheap to change every frame
+
+BOX_API void Box_drawNode(Box_Node* node, SDL_Rect dest); //queued in the engine's sprite batch
 
-BOX_API void Box_drawNode(Box_Node* node, SDL_Rect dest);
+BOX_API void Box_setAutoDrawNode(Box_Node* node, bool autoDraw);
+BOX_API bool Box_getAutoDrawNode(Box_Node* node);
+BOX_API void Box_autoDrawRecursiveNode(Box_Node* node); //draw every auto-draw node at its world position and scale
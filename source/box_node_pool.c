@@ -0,0 +1,141 @@
+#include "box_node_pool.h"
+
+#include "toy_memory.h"
+
+//utils
+static void pushSlabUtil(Box_NodePool* pool, int size) {
+	if (pool->count + 1 > pool->capacity) {
+		int oldCapacity = pool->capacity;
+
+		pool->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		pool->slabs = TOY_GROW_ARRAY(Box_NodeSlab, pool->slabs, oldCapacity, pool->capacity);
+	}
+
+	Box_NodeSlab* slab = &pool->slabs[pool->count++];
+
+	slab->nodes = TOY_ALLOCATE(Box_Node, size);
+	slab->size = size;
+
+	//each node keeps its children array for its whole lifetime
+	for (int i = 0; i < size; i++) {
+		slab->nodes[i].functions = NULL;
+		slab->nodes[i].children = NULL;
+		slab->nodes[i].capacity = 0;
+
+		//push onto the free list
+		slab->nodes[i].parent = pool->freeList;
+		pool->freeList = &slab->nodes[i];
+	}
+
+	pool->freeCount += size;
+}
+
+//empty the dictionary without releasing its entries - removing would leave tombstones, which are never reused
+static void clearDictionaryUtil(Toy_LiteralDictionary* dictionary) {
+	for (int i = 0; i < dictionary->capacity; i++) {
+		Toy_freeLiteral(dictionary->entries[i].key);
+		Toy_freeLiteral(dictionary->entries[i].value);
+
+		dictionary->entries[i].key = TOY_TO_NULL_LITERAL;
+		dictionary->entries[i].value = TOY_TO_NULL_LITERAL;
+	}
+
+	//contains drives the grow check, so it must be reset too
+	dictionary->count = 0;
+	dictionary->contains = 0;
+}
+
+//exposed functions
+void Box_initNodePool(Box_NodePool* pool) {
+	pool->slabs = NULL;
+	pool->capacity = 0;
+	pool->count = 0;
+	pool->freeList = NULL;
+	pool->freeCount = 0;
+	pool->freeTables = NULL;
+}
+
+void Box_freeNodePool(Box_NodePool* pool) {
+	for (int i = 0; i < pool->count; i++) {
+		Box_NodeSlab* slab = &pool->slabs[i];
+
+		for (int j = 0; j < slab->size; j++) {
+			TOY_FREE_ARRAY(Box_Node*, slab->nodes[j].children, slab->nodes[j].capacity);
+		}
+
+		TOY_FREE_ARRAY(Box_Node, slab->nodes, slab->size);
+	}
+
+	TOY_FREE_ARRAY(Box_NodeSlab, pool->slabs, pool->capacity);
+
+	//tables still in use belong to their owners
+	while (pool->freeTables != NULL) {
+		Box_FunctionTable* next = pool->freeTables->next;
+		Toy_freeLiteralDictionary(&pool->freeTables->functions);
+		TOY_FREE(Box_FunctionTable, pool->freeTables);
+		pool->freeTables = next;
+	}
+
+	Box_initNodePool(pool);
+}
+
+Box_Node* Box_allocateNodePool(Box_NodePool* pool) {
+	if (pool->freeList == NULL) {
+		pushSlabUtil(pool, BOX_NODE_SLAB_SIZE);
+	}
+
+	//pop from the free list
+	Box_Node* node = pool->freeList;
+	pool->freeList = node->parent;
+	pool->freeCount--;
+
+	node->parent = NULL;
+
+	return node;
+}
+
+void Box_releaseNodePool(Box_NodePool* pool, Box_Node* node) {
+	node->functions = NULL;
+	node->count = 0;
+	node->childCount = 0;
+
+	//push onto the free list
+	node->parent = pool->freeList;
+	pool->freeList = node;
+	pool->freeCount++;
+}
+
+Box_FunctionTable* Box_allocateFunctionTablePool(Box_NodePool* pool) {
+	Box_FunctionTable* table = pool->freeTables;
+
+	if (table != NULL) {
+		pool->freeTables = table->next;
+	}
+	else {
+		table = TOY_ALLOCATE(Box_FunctionTable, 1);
+		Toy_initLiteralDictionary(&table->functions);
+	}
+
+	table->hooks = 0;
+	table->refCount = 1;
+	table->next = NULL;
+
+	return table;
+}
+
+void Box_releaseFunctionTablePool(Box_NodePool* pool, Box_FunctionTable* table) {
+	clearDictionaryUtil(&table->functions);
+
+	table->next = pool->freeTables;
+	pool->freeTables = table;
+}
+
+void Box_reserveNodePool(Box_NodePool* pool, int count) {
+	if (pool->freeCount < count) {
+		pushSlabUtil(pool, count - pool->freeCount);
+	}
+}
+
+int Box_getFreeCountNodePool(Box_NodePool* pool) {
+	return pool->freeCount;
+}
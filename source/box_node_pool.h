@@ -0,0 +1,40 @@
+#pragma once
+
+#include "box_common.h"
+#include "box_node.h"
+
+#include "toy_literal_dictionary.h"
+
+#define BOX_NODE_SLAB_SIZE 64
+
+//a block of nodes, allocated together
+typedef struct Box_private_node_slab {
+	Box_Node* nodes;
+	int size;
+} Box_NodeSlab;
+
+//recycles nodes, so spawning and freeing them doesn't hit malloc every frame
+typedef struct Box_private_node_pool {
+	Box_NodeSlab* slabs;
+	int capacity;
+	int count;
+
+	//released nodes, linked through their parent pointers
+	Box_Node* freeList;
+	int freeCount;
+
+	//released function tables, which keep their dictionaries
+	Box_FunctionTable* freeTables;
+} Box_NodePool;
+
+BOX_API void Box_initNodePool(Box_NodePool* pool);
+BOX_API void Box_freeNodePool(Box_NodePool* pool); //NOTE: frees every node, including any still in use
+
+BOX_API Box_Node* Box_allocateNodePool(Box_NodePool* pool); //the result still needs Box_initNode()
+BOX_API void Box_releaseNodePool(Box_NodePool* pool, Box_Node* node); //used by Box_freeNode()
+
+BOX_API Box_FunctionTable* Box_allocateFunctionTablePool(Box_NodePool* pool); //the result is empty, with a refCount of 1
+BOX_API void Box_releaseFunctionTablePool(Box_NodePool* pool, Box_FunctionTable* table); //used by Box_releaseFunctionTable()
+
+BOX_API void Box_reserveNodePool(Box_NodePool* pool, int count); //make sure "count" nodes can be allocated without growing
+BOX_API int Box_getFreeCountNodePool(Box_NodePool* pool);
@@ -0,0 +1,323 @@
+#include "box_pack.h"
+#include "box_file_view.h"
+
+
+#include "toy_memory.h"
+#include "toy_console_colors.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/* the LZ scheme - a stream of tokens, each starting with a control byte:
+
+	0xxxxxxx: a run of (x + 1) literal bytes follows
+	1xxxxxxx: copy (x + 4) bytes from u16 offset bytes back, where the offset follows
+
+simple enough to decode without tables, and tools/pack_builder.c holds the encoder
+*/
+
+//one file within a pack
+typedef struct Box_private_pack_entry {
+	const char* name; //points into the mapping, NOT null-terminated
+	size_t nameLength;
+	unsigned int flags;
+	const unsigned char* data; //within the mapping
+	size_t storedSize;
+	size_t size;
+	unsigned char* decompressed; //filled on first use, if compressed
+} Box_PackEntry;
+
+typedef struct Box_private_pack {
+	Box_FileView file;
+	time_t modified;
+
+	Box_PackEntry* entries; //sorted by name
+	int count;
+} Box_Pack;
+
+//like the drive system, the mounted packs are a global
+static Box_Pack* packs = NULL;
+static int capacity = 0;
+static int count = 0;
+static SDL_mutex* mutex = NULL; //guards the packs array, and the decompression on first use
+
+//utils
+static Uint32 readU32Util(const unsigned char* p) {
+	return (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
+static Uint64 readU64Util(const unsigned char* p) {
+	return (Uint64)readU32Util(p) | ((Uint64)readU32Util(p + 4) << 32);
+}
+
+static int compareNameUtil(const char* name, size_t nameLength, const char* path, size_t pathLength) {
+	size_t length = nameLength < pathLength ? nameLength : pathLength;
+	int result = memcmp(name, path, length);
+
+	if (result != 0) {
+		return result;
+	}
+
+	return nameLength < pathLength ? -1 : nameLength > pathLength ? 1 : 0;
+}
+
+static Box_PackEntry* findEntryUtil(const char* filePath, time_t* modified) {
+	size_t pathLength = strlen(filePath);
+	Box_PackEntry* found = NULL;
+
+	//the array can move while mounting, but the entries themselves stay put
+	SDL_LockMutex(mutex);
+
+	//newest first
+	for (int p = count - 1; p >= 0 && found == NULL; p--) {
+		int low = 0;
+		int high = packs[p].count - 1;
+
+		while (low <= high) {
+			int mid = (low + high) / 2;
+			Box_PackEntry* entry = &packs[p].entries[mid];
+			int result = compareNameUtil(entry->name, entry->nameLength, filePath, pathLength);
+
+			if (result == 0) {
+				if (modified != NULL) {
+					*modified = packs[p].modified;
+				}
+				found = entry;
+				break;
+			}
+
+			if (result < 0) {
+				low = mid + 1;
+			}
+			else {
+				high = mid - 1;
+			}
+		}
+	}
+
+	SDL_UnlockMutex(mutex);
+
+	return found;
+}
+
+static bool readDirectoryUtil(Box_Pack* pack) {
+	if (pack->file.size < BOX_PACK_HEADER_SIZE || memcmp(pack->file.data, BOX_PACK_MAGIC, 8) != 0) {
+		return false;
+	}
+
+	Uint32 entryCount = readU32Util(pack->file.data + 8);
+
+	if ((Uint64)entryCount * BOX_PACK_RECORD_SIZE > pack->file.size - BOX_PACK_HEADER_SIZE) {
+		return false;
+	}
+
+	pack->entries = TOY_ALLOCATE(Box_PackEntry, entryCount);
+	pack->count = (int)entryCount;
+
+	for (Uint32 i = 0; i < entryCount; i++) {
+		const unsigned char* record = pack->file.data + BOX_PACK_HEADER_SIZE + i * BOX_PACK_RECORD_SIZE;
+
+		Uint64 nameOffset = readU32Util(record);
+		Uint64 nameLength = readU32Util(record + 4);
+		Uint64 dataOffset = readU64Util(record + 16);
+		Uint64 storedSize = readU64Util(record + 24);
+
+		//everything must be within the file
+		if (nameOffset + nameLength > pack->file.size || dataOffset > pack->file.size || storedSize > pack->file.size - dataOffset) {
+			TOY_FREE_ARRAY(Box_PackEntry, pack->entries, entryCount);
+			return false;
+		}
+
+		Box_PackEntry* entry = &pack->entries[i];
+
+		entry->name = (const char*)(pack->file.data + nameOffset);
+		entry->nameLength = (size_t)nameLength;
+		entry->flags = readU32Util(record + 8);
+		entry->data = pack->file.data + dataOffset;
+		entry->storedSize = (size_t)storedSize;
+		entry->size = (size_t)readU64Util(record + 32);
+		entry->decompressed = NULL;
+	}
+
+	return true;
+}
+
+//exposed functions
+void Box_initPacks() {
+	mutex = SDL_CreateMutex();
+}
+
+int Box_mountPack(const char* packPath) {
+	Box_Pack pack;
+
+	if (Box_mapFileView(&pack.file, packPath) != 0) {
+		fprintf(stderr, TOY_CC_ERROR "Could not open pack \"%s\"\n" TOY_CC_RESET, packPath);
+		return -1;
+	}
+
+	if (!readDirectoryUtil(&pack)) {
+		fprintf(stderr, TOY_CC_ERROR "Pack \"%s\" is corrupt\n" TOY_CC_RESET, packPath);
+		Box_closeFileView(&pack.file);
+		return -1;
+	}
+
+	struct stat fileStat;
+	pack.modified = stat(packPath, &fileStat) == 0 ? fileStat.st_mtime : 0;
+
+	SDL_LockMutex(mutex);
+
+	if (count + 1 > capacity) {
+		int oldCapacity = capacity;
+
+		capacity = TOY_GROW_CAPACITY(oldCapacity);
+		packs = TOY_GROW_ARRAY(Box_Pack, packs, oldCapacity, capacity);
+	}
+
+	packs[count++] = pack;
+
+	SDL_UnlockMutex(mutex);
+
+	return 0;
+}
+
+void Box_freePacks() {
+	for (int p = 0; p < count; p++) {
+		for (int i = 0; i < packs[p].count; i++) {
+			if (packs[p].entries[i].decompressed != NULL) {
+				TOY_FREE_ARRAY(unsigned char, packs[p].entries[i].decompressed, packs[p].entries[i].size + 1);
+			}
+		}
+
+		TOY_FREE_ARRAY(Box_PackEntry, packs[p].entries, packs[p].count);
+		Box_closeFileView(&packs[p].file);
+	}
+
+	TOY_FREE_ARRAY(Box_Pack, packs, capacity);
+
+	packs = NULL;
+	capacity = 0;
+	count = 0;
+
+	if (mutex != NULL) {
+		SDL_DestroyMutex(mutex);
+		mutex = NULL;
+	}
+}
+
+const unsigned char* Box_findPack(const char* filePath, size_t* size, bool* terminated) {
+	Box_PackEntry* entry = findEntryUtil(filePath, NULL);
+
+	if (entry == NULL) {
+		return NULL;
+	}
+
+	*size = entry->size;
+
+	if (!(entry->flags & BOX_PACK_FLAG_COMPRESSED)) {
+		if (terminated != NULL) {
+			*terminated = false;
+		}
+		return entry->data;
+	}
+
+	if (terminated != NULL) {
+		*terminated = true;
+	}
+
+	//decompress once, and keep it for as long as the pack is mounted
+	SDL_LockMutex(mutex);
+
+	if (entry->decompressed == NULL) {
+		unsigned char* buffer = TOY_ALLOCATE(unsigned char, entry->size + 1); //null-terminated, so it can be read as a string
+
+		if (Box_decompressPack(entry->data, entry->storedSize, buffer, entry->size) != entry->size) {
+			fprintf(stderr, TOY_CC_ERROR "Could not decompress \"%s\" from its pack\n" TOY_CC_RESET, filePath);
+			TOY_FREE_ARRAY(unsigned char, buffer, entry->size + 1);
+			buffer = NULL;
+		}
+		else {
+			buffer[entry->size] = '\0';
+		}
+
+		entry->decompressed = buffer;
+	}
+
+	SDL_UnlockMutex(mutex);
+
+	return entry->decompressed;
+}
+
+bool Box_statFilePack(const char* filePath, time_t* modified, long long* size) {
+	Box_PackEntry* entry = findEntryUtil(filePath, modified);
+
+	if (entry != NULL) {
+		*size = (long long)entry->size;
+		return true;
+	}
+
+	struct stat fileStat;
+	if (stat(filePath, &fileStat) != 0) {
+		return false;
+	}
+
+	*modified = fileStat.st_mtime;
+	*size = (long long)fileStat.st_size;
+	return true;
+}
+
+SDL_RWops* Box_openRWPack(const char* filePath) {
+	size_t size = 0;
+	const unsigned char* view = Box_findPack(filePath, &size, NULL);
+
+	if (view != NULL) {
+		return SDL_RWFromConstMem(view, (int)size);
+	}
+
+	return SDL_RWFromFile(filePath, "rb");
+}
+
+size_t Box_decompressPack(const unsigned char* src, size_t srcSize, unsigned char* dest, size_t destSize) {
+	size_t in = 0;
+	size_t out = 0;
+
+	while (in < srcSize) {
+		unsigned int control = src[in++];
+
+		if (control < 0x80) {
+			//literal run
+			size_t length = control + 1;
+
+			if (length > srcSize - in || length > destSize - out) {
+				return 0;
+			}
+
+			memcpy(dest + out, src + in, length);
+			in += length;
+			out += length;
+		}
+		else {
+			//back reference
+			size_t length = (control & 0x7F) + 4;
+
+			if (in + 2 > srcSize) {
+				return 0;
+			}
+
+			size_t offset = (size_t)src[in] | ((size_t)src[in + 1] << 8);
+			in += 2;
+
+			if (offset == 0 || offset > out || length > destSize - out) {
+				return 0;
+			}
+
+			//byte by byte, as the ranges can overlap
+			for (size_t i = 0; i < length; i++, out++) {
+				dest[out] = dest[out - offset];
+			}
+		}
+	}
+
+	return out;
+}
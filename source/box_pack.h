@@ -0,0 +1,30 @@
+#pragma once
+
+#include "box_common.h"
+
+#include <time.h>
+
+/* pack file layout, all integers little-endian:
+
+	header:    "BOXPACK1", u32 entry count, u32 reserved
+	directory: per entry, sorted by name - u32 name offset, u32 name length, u32 flags, u32 reserved, u64 data offset, u64 stored size, u64 size
+	names and data follow, at the offsets given
+
+names are the file paths the drive system resolves to, such as "assets/scripts/root.toy", so lookups need no extra step
+*/
+#define BOX_PACK_MAGIC "BOXPACK1"
+#define BOX_PACK_HEADER_SIZE 16
+#define BOX_PACK_RECORD_SIZE 40
+
+#define BOX_PACK_FLAG_COMPRESSED 1 //stored with the LZ scheme described in box_pack.c
+
+BOX_API void Box_initPacks(); //call before starting any thread which reads files
+BOX_API int Box_mountPack(const char* packPath); //packs mounted later take priority, and all of them over loose files - safe while loads are running, on the main thread
+BOX_API void Box_freePacks(); //unmount everything - anything read from the packs must be freed first, and no loads may be running
+
+//these are safe to call from any thread, alongside Box_mountPack()
+BOX_API const unsigned char* Box_findPack(const char* filePath, size_t* size, bool* terminated); //a view of a packed file, or NULL - valid until Box_freePacks() (terminated can be NULL)
+BOX_API bool Box_statFilePack(const char* filePath, time_t* modified, long long* size); //for packed files, the pack's modification time is given
+BOX_API SDL_RWops* Box_openRWPack(const char* filePath); //for SDL's loaders, which can take ownership of it
+
+BOX_API size_t Box_decompressPack(const unsigned char* src, size_t srcSize, unsigned char* dest, size_t destSize); //returns the bytes written, or 0 on error
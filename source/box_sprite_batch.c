@@ -0,0 +1,174 @@
+#include "box_sprite_batch.h"
+
+#include "toy_memory.h"
+
+#include <stdlib.h>
+
+//utils
+static int compareSpritesUtil(const void* lhs, const void* rhs) {
+	const Box_Sprite* a = (const Box_Sprite*)lhs;
+	const Box_Sprite* b = (const Box_Sprite*)rhs;
+
+	//lower layers MUST come first
+	if (a->layer != b->layer) {
+		return a->layer < b->layer ? -1 : 1;
+	}
+
+	//group by texture, only within the layers which opted in
+	if (a->grouped && a->texture != b->texture) {
+		return (uintptr_t)a->texture < (uintptr_t)b->texture ? -1 : 1;
+	}
+
+	return a->order - b->order;
+}
+
+static void growGeometryUtil(Box_SpriteBatch* batch, int quads) {
+	int oldCapacity = batch->geometryCapacity;
+
+	while (batch->geometryCapacity < quads) {
+		batch->geometryCapacity = TOY_GROW_CAPACITY(batch->geometryCapacity);
+	}
+
+	batch->vertices = TOY_GROW_ARRAY(SDL_Vertex, batch->vertices, oldCapacity * 4, batch->geometryCapacity * 4);
+	batch->indices = TOY_GROW_ARRAY(int, batch->indices, oldCapacity * 6, batch->geometryCapacity * 6);
+
+	//the index pattern never changes, since each run's vertices are passed from their own start
+	for (int i = oldCapacity; i < batch->geometryCapacity; i++) {
+		batch->indices[i * 6 + 0] = i * 4 + 0;
+		batch->indices[i * 6 + 1] = i * 4 + 1;
+		batch->indices[i * 6 + 2] = i * 4 + 2;
+		batch->indices[i * 6 + 3] = i * 4 + 2;
+		batch->indices[i * 6 + 4] = i * 4 + 1;
+		batch->indices[i * 6 + 5] = i * 4 + 3;
+	}
+}
+
+static bool isGroupedUtil(Box_SpriteBatch* batch, int layer) {
+	for (int i = 0; i < batch->groupedCount; i++) {
+		if (batch->groupedLayers[i] == layer) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//exposed functions
+void Box_initSpriteBatch(Box_SpriteBatch* batch) {
+	batch->sprites = NULL;
+	batch->capacity = 0;
+	batch->count = 0;
+	batch->vertices = NULL;
+	batch->indices = NULL;
+	batch->geometryCapacity = 0;
+	batch->groupedLayers = NULL;
+	batch->groupedCapacity = 0;
+	batch->groupedCount = 0;
+	batch->drawCalls = 0;
+}
+
+void Box_freeSpriteBatch(Box_SpriteBatch* batch) {
+	TOY_FREE_ARRAY(Box_Sprite, batch->sprites, batch->capacity);
+	TOY_FREE_ARRAY(SDL_Vertex, batch->vertices, batch->geometryCapacity * 4);
+	TOY_FREE_ARRAY(int, batch->indices, batch->geometryCapacity * 6);
+	TOY_FREE_ARRAY(int, batch->groupedLayers, batch->groupedCapacity);
+
+	Box_initSpriteBatch(batch);
+}
+
+void Box_pushSpriteBatch(Box_SpriteBatch* batch, SDL_Texture* texture, SDL_Rect src, SDL_Rect dest, int layer) {
+	Box_pushTintedSpriteBatch(batch, texture, src, dest, layer, (SDL_Color){ 255, 255, 255, 255 });
+}
+
+void Box_pushTintedSpriteBatch(Box_SpriteBatch* batch, SDL_Texture* texture, SDL_Rect src, SDL_Rect dest, int layer, SDL_Color color) {
+	if (batch->count + 1 > batch->capacity) {
+		int oldCapacity = batch->capacity;
+
+		batch->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		batch->sprites = TOY_GROW_ARRAY(Box_Sprite, batch->sprites, oldCapacity, batch->capacity);
+	}
+
+	batch->sprites[batch->count] = (Box_Sprite){ .texture = texture, .src = src, .dest = dest, .color = color, .layer = layer, .order = batch->count, .grouped = batch->groupedCount > 0 && isGroupedUtil(batch, layer) };
+	batch->count++;
+}
+
+void Box_setGroupedLayerSpriteBatch(Box_SpriteBatch* batch, int layer, bool grouped) {
+	for (int i = 0; i < batch->groupedCount; i++) {
+		if (batch->groupedLayers[i] == layer) {
+			if (!grouped) {
+				batch->groupedLayers[i] = batch->groupedLayers[--batch->groupedCount];
+			}
+			return;
+		}
+	}
+
+	if (!grouped) {
+		return;
+	}
+
+	if (batch->groupedCount + 1 > batch->groupedCapacity) {
+		int oldCapacity = batch->groupedCapacity;
+
+		batch->groupedCapacity = TOY_GROW_CAPACITY(oldCapacity);
+		batch->groupedLayers = TOY_GROW_ARRAY(int, batch->groupedLayers, oldCapacity, batch->groupedCapacity);
+	}
+
+	batch->groupedLayers[batch->groupedCount++] = layer;
+}
+
+void Box_flushSpriteBatch(Box_SpriteBatch* batch, SDL_Renderer* renderer) {
+	batch->drawCalls = 0;
+
+	if (batch->count == 0) {
+		return;
+	}
+
+	qsort(batch->sprites, batch->count, sizeof(Box_Sprite), compareSpritesUtil);
+
+	if (batch->count > batch->geometryCapacity) {
+		growGeometryUtil(batch, batch->count);
+	}
+
+	//one draw call per run of adjacent sprites sharing a texture
+	int runStart = 0;
+	int textureWidth = 0;
+	int textureHeight = 0;
+
+	for (int i = 0; i < batch->count; i++) {
+		Box_Sprite* sprite = &batch->sprites[i];
+
+		if (i == runStart) {
+			SDL_QueryTexture(sprite->texture, NULL, NULL, &textureWidth, &textureHeight);
+		}
+
+		//texture coordinates
+		float u0 = (float)sprite->src.x / textureWidth;
+		float v0 = (float)sprite->src.y / textureHeight;
+		float u1 = (float)(sprite->src.x + sprite->src.w) / textureWidth;
+		float v1 = (float)(sprite->src.y + sprite->src.h) / textureHeight;
+
+		//screen coordinates
+		float x0 = (float)sprite->dest.x;
+		float y0 = (float)sprite->dest.y;
+		float x1 = (float)(sprite->dest.x + sprite->dest.w);
+		float y1 = (float)(sprite->dest.y + sprite->dest.h);
+
+		SDL_Vertex* quad = &batch->vertices[i * 4];
+
+		quad[0] = (SDL_Vertex){ { x0, y0 }, sprite->color, { u0, v0 } };
+		quad[1] = (SDL_Vertex){ { x1, y0 }, sprite->color, { u1, v0 } };
+		quad[2] = (SDL_Vertex){ { x0, y1 }, sprite->color, { u0, v1 } };
+		quad[3] = (SDL_Vertex){ { x1, y1 }, sprite->color, { u1, v1 } };
+
+		//submit at the end of each run
+		if (i + 1 == batch->count || batch->sprites[i + 1].texture != sprite->texture) {
+			int quads = i + 1 - runStart;
+			SDL_RenderGeometry(renderer, sprite->texture, &batch->vertices[runStart * 4], quads * 4, batch->indices, quads * 6);
+			batch->drawCalls++;
+
+			runStart = i + 1;
+		}
+	}
+
+	batch->count = 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "box_common.h"
+
+//a single queued draw
+typedef struct Box_private_sprite {
+	SDL_Texture* texture;
+	SDL_Rect src;
+	SDL_Rect dest;
+	SDL_Color color; //multiplied with the texture
+	int layer;
+	int order; //submission order, keeps the sort stable
+	bool grouped; //the layer allows reordering by texture
+} Box_Sprite;
+
+//collects a frame's sprites, then submits them with as few draw calls as possible
+typedef struct Box_private_sprite_batch {
+	Box_Sprite* sprites;
+	int capacity;
+	int count;
+
+	//reused between flushes
+	SDL_Vertex* vertices;
+	int* indices;
+	int geometryCapacity; //in quads
+
+	//layers whose sprites don't overlap, so can be grouped by texture
+	int* groupedLayers;
+	int groupedCapacity;
+	int groupedCount;
+
+	//statistics for the last flush
+	int drawCalls;
+} Box_SpriteBatch;
+
+BOX_API void Box_initSpriteBatch(Box_SpriteBatch* batch);
+BOX_API void Box_freeSpriteBatch(Box_SpriteBatch* batch);
+
+BOX_API void Box_pushSpriteBatch(Box_SpriteBatch* batch, SDL_Texture* texture, SDL_Rect src, SDL_Rect dest, int layer);
+BOX_API void Box_pushTintedSpriteBatch(Box_SpriteBatch* batch, SDL_Texture* texture, SDL_Rect src, SDL_Rect dest, int layer, SDL_Color color);
+
+BOX_API void Box_setGroupedLayerSpriteBatch(Box_SpriteBatch* batch, int layer, bool grouped); //only for layers where draw order within the layer doesn't matter
+
+//sort by layer, keeping painter's order unless the layer is grouped, and draw everything to the current render target
+//NOTE: must be called before changing the render target, or presenting
+BOX_API void Box_flushSpriteBatch(Box_SpriteBatch* batch, SDL_Renderer* renderer);
@@ -0,0 +1,240 @@
+#include "box_texture_cache.h"
+#include "box_pack.h"
+
+#include "toy_memory.h"
+
+#include <stdlib.h>
+
+//utils
+static void freeEntryUtil(Box_TextureCacheEntry* entry) {
+	if (!entry->atlased) {
+		SDL_DestroyTexture(entry->texture);
+	}
+
+	Toy_freeLiteral(entry->filePathLiteral);
+	TOY_FREE(Box_TextureCacheEntry, entry);
+}
+
+//copy the live entries into a fresh dictionary, dropping the tombstones
+static void rebuildEntriesUtil(Box_TextureCache* cache) {
+	Toy_LiteralDictionary entries;
+	Toy_initLiteralDictionary(&entries);
+
+	for (int i = 0; i < cache->entries.capacity; i++) {
+		if (!TOY_IS_NULL(cache->entries.entries[i].key)) {
+			Toy_setLiteralDictionary(&entries, cache->entries.entries[i].key, cache->entries.entries[i].value);
+		}
+	}
+
+	Toy_freeLiteralDictionary(&cache->entries); //the entries are opaque, so they survive this
+	cache->entries = entries;
+	cache->removed = 0;
+}
+
+static Box_AtlasPage* pushPageUtil(Box_TextureCache* cache, SDL_Renderer* renderer) {
+	SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, BOX_ATLAS_PAGE_SIZE, BOX_ATLAS_PAGE_SIZE);
+
+	if (texture == NULL) {
+		return NULL;
+	}
+
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+	//clear the page, so filtering at the edges doesn't pick up garbage
+	void* blank = calloc(BOX_ATLAS_PAGE_SIZE * BOX_ATLAS_PAGE_SIZE, 4);
+
+	if (blank == NULL) {
+		SDL_DestroyTexture(texture);
+		return NULL; //the image gets a texture of its own instead
+	}
+
+	SDL_UpdateTexture(texture, NULL, blank, BOX_ATLAS_PAGE_SIZE * 4);
+	free(blank);
+
+	if (cache->count + 1 > cache->capacity) {
+		int oldCapacity = cache->capacity;
+
+		cache->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		cache->pages = TOY_GROW_ARRAY(Box_AtlasPage, cache->pages, oldCapacity, cache->capacity);
+	}
+
+	Box_AtlasPage* page = &cache->pages[cache->count++];
+
+	page->texture = texture;
+	page->shelfX = 0;
+	page->shelfY = 0;
+	page->shelfHeight = 0;
+
+	return page;
+}
+
+//find room for a w * h image on the last page, starting a new shelf or page when needed
+static Box_AtlasPage* reserveUtil(Box_TextureCache* cache, SDL_Renderer* renderer, int w, int h, SDL_Rect* region) {
+	Box_AtlasPage* page = cache->count > 0 ? &cache->pages[cache->count - 1] : NULL;
+
+	if (page != NULL && page->shelfX + w > BOX_ATLAS_PAGE_SIZE) {
+		page->shelfX = 0;
+		page->shelfY += page->shelfHeight + BOX_ATLAS_PADDING;
+		page->shelfHeight = 0;
+	}
+
+	if (page == NULL || page->shelfY + h > BOX_ATLAS_PAGE_SIZE) {
+		page = pushPageUtil(cache, renderer);
+
+		if (page == NULL) {
+			return NULL;
+		}
+	}
+
+	*region = (SDL_Rect){ page->shelfX, page->shelfY, w, h };
+
+	page->shelfX += w + BOX_ATLAS_PADDING;
+	if (page->shelfHeight < h) {
+		page->shelfHeight = h;
+	}
+
+	return page;
+}
+
+static bool packUtil(Box_TextureCache* cache, SDL_Renderer* renderer, SDL_Surface* surface, Box_TextureCacheEntry* entry) {
+	//the pages have a fixed format
+	SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+
+	if (converted == NULL) {
+		return false;
+	}
+
+	Box_AtlasPage* page = reserveUtil(cache, renderer, converted->w, converted->h, &entry->region);
+
+	if (page == NULL) {
+		SDL_FreeSurface(converted);
+		return false;
+	}
+
+	SDL_UpdateTexture(page->texture, &entry->region, converted->pixels, converted->pitch);
+	SDL_FreeSurface(converted);
+
+	entry->texture = page->texture;
+	entry->atlased = true;
+
+	return true;
+}
+
+static Box_TextureCacheEntry* retainUtil(Box_TextureCache* cache, Toy_Literal filePathLiteral) {
+	if (!Toy_existsLiteralDictionary(&cache->entries, filePathLiteral)) {
+		return NULL;
+	}
+
+	Toy_Literal entryLiteral = Toy_getLiteralDictionary(&cache->entries, filePathLiteral);
+	Box_TextureCacheEntry* entry = TOY_AS_OPAQUE(entryLiteral);
+	Toy_freeLiteral(entryLiteral);
+
+	entry->refCount++;
+	return entry;
+}
+
+static Box_TextureCacheEntry* uploadUtil(Box_TextureCache* cache, SDL_Renderer* renderer, Toy_Literal filePathLiteral, SDL_Surface* surface) {
+	Box_TextureCacheEntry* entry = TOY_ALLOCATE(Box_TextureCacheEntry, 1);
+	entry->atlased = false;
+
+	//small images are packed together, when enabled
+	bool packed = cache->atlasEnabled && surface->w <= BOX_ATLAS_MAX_IMAGE_SIZE && surface->h <= BOX_ATLAS_MAX_IMAGE_SIZE && packUtil(cache, renderer, surface, entry);
+
+	if (!packed) {
+		entry->texture = SDL_CreateTextureFromSurface(renderer, surface);
+		entry->region = (SDL_Rect){ 0, 0, surface->w, surface->h };
+	}
+
+	if (entry->texture == NULL) {
+		TOY_FREE(Box_TextureCacheEntry, entry);
+		return NULL;
+	}
+
+	entry->filePathLiteral = Toy_copyLiteral(filePathLiteral);
+	entry->refCount = 1;
+
+	Toy_Literal entryLiteral = TOY_TO_OPAQUE_LITERAL(entry, BOX_OPAQUE_TAG_TEXTURE_CACHE_ENTRY);
+	Toy_setLiteralDictionary(&cache->entries, filePathLiteral, entryLiteral);
+	Toy_freeLiteral(entryLiteral);
+
+	return entry;
+}
+
+//exposed functions
+void Box_initTextureCache(Box_TextureCache* cache) {
+	Toy_initLiteralDictionary(&cache->entries);
+	cache->removed = 0;
+	cache->pages = NULL;
+	cache->capacity = 0;
+	cache->count = 0;
+	cache->atlasEnabled = false;
+}
+
+void Box_freeTextureCache(Box_TextureCache* cache) {
+	//the entries are opaque, so free them manually
+	for (int i = 0; i < cache->entries.capacity; i++) {
+		if (TOY_IS_NULL(cache->entries.entries[i].key)) {
+			continue;
+		}
+
+		freeEntryUtil(TOY_AS_OPAQUE(cache->entries.entries[i].value));
+	}
+
+	Toy_freeLiteralDictionary(&cache->entries);
+
+	for (int i = 0; i < cache->count; i++) {
+		SDL_DestroyTexture(cache->pages[i].texture);
+	}
+
+	TOY_FREE_ARRAY(Box_AtlasPage, cache->pages, cache->capacity);
+
+	cache->pages = NULL;
+	cache->capacity = 0;
+	cache->count = 0;
+}
+
+Box_TextureCacheEntry* Box_loadTextureCache(Box_TextureCache* cache, SDL_Renderer* renderer, Toy_Literal filePathLiteral) {
+	//already loaded
+	Box_TextureCacheEntry* entry = retainUtil(cache, filePathLiteral);
+
+	if (entry != NULL) {
+		return entry;
+	}
+
+	SDL_Surface* surface = IMG_Load_RW(Box_openRWPack(Toy_toCString(TOY_AS_STRING(filePathLiteral))), 1);
+
+	if (surface == NULL) {
+		return NULL;
+	}
+
+	entry = uploadUtil(cache, renderer, filePathLiteral, surface);
+	SDL_FreeSurface(surface);
+
+	return entry;
+}
+
+Box_TextureCacheEntry* Box_storeSurfaceTextureCache(Box_TextureCache* cache, SDL_Renderer* renderer, Toy_Literal filePathLiteral, SDL_Surface* surface) {
+	//loaded by someone else in the meantime
+	Box_TextureCacheEntry* entry = retainUtil(cache, filePathLiteral);
+
+	if (entry != NULL) {
+		return entry;
+	}
+
+	return uploadUtil(cache, renderer, filePathLiteral, surface);
+}
+
+void Box_releaseTextureCache(Box_TextureCache* cache, Box_TextureCacheEntry* entry) {
+	if (--entry->refCount > 0 || entry->atlased) {
+		return;
+	}
+
+	//nobody uses this texture anymore
+	Toy_removeLiteralDictionary(&cache->entries, entry->filePathLiteral);
+	freeEntryUtil(entry);
+
+	//tombstones are never reused, so streaming textures would eventually fill the dictionary
+	if (++cache->removed >= cache->entries.capacity / 4) {
+		rebuildEntriesUtil(cache);
+	}
+}
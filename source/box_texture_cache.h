@@ -0,0 +1,50 @@
+#pragma once
+
+#include "box_common.h"
+
+#include "toy_literal.h"
+#include "toy_literal_dictionary.h"
+
+//NOTE: only used internally, never exposed to scripts
+#define BOX_OPAQUE_TAG_TEXTURE_CACHE_ENTRY 1002
+
+//atlas settings
+#define BOX_ATLAS_PAGE_SIZE 1024
+#define BOX_ATLAS_MAX_IMAGE_SIZE 256 //larger images get a texture of their own
+#define BOX_ATLAS_PADDING 1
+
+//a loaded image, shared by every node using it
+typedef struct Box_private_texture_cache_entry {
+	SDL_Texture* texture; //an atlas page, or a texture of its own
+	SDL_Rect region; //the image within the texture
+	Toy_Literal filePathLiteral;
+	int refCount;
+	bool atlased; //atlas space isn't reclaimed, so these stay cached until the cache is freed
+} Box_TextureCacheEntry;
+
+//a texture holding many small images, packed in rows ("shelves")
+typedef struct Box_private_atlas_page {
+	SDL_Texture* texture;
+	int shelfX;
+	int shelfY;
+	int shelfHeight;
+} Box_AtlasPage;
+
+//loaded images, keyed by their resolved drive path
+typedef struct Box_private_texture_cache {
+	Toy_LiteralDictionary entries; //file path -> opaque entry
+	int removed; //tombstones left in entries, which are never reused, so it's rebuilt once they pile up
+
+	Box_AtlasPage* pages;
+	int capacity;
+	int count;
+
+	bool atlasEnabled; //only affects images loaded afterwards
+} Box_TextureCache;
+
+BOX_API void Box_initTextureCache(Box_TextureCache* cache);
+BOX_API void Box_freeTextureCache(Box_TextureCache* cache);
+
+BOX_API Box_TextureCacheEntry* Box_loadTextureCache(Box_TextureCache* cache, SDL_Renderer* renderer, Toy_Literal filePathLiteral); //retains the entry, or returns NULL on error
+BOX_API Box_TextureCacheEntry* Box_storeSurfaceTextureCache(Box_TextureCache* cache, SDL_Renderer* renderer, Toy_Literal filePathLiteral, SDL_Surface* surface); //as above, for an image decoded elsewhere (the surface isn't freed)
+BOX_API void Box_releaseTextureCache(Box_TextureCache* cache, Box_TextureCacheEntry* entry);
@@ -0,0 +1,135 @@
+#include "box_transform_store.h"
+
+#include "toy_memory.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//exposed functions
+void Box_initTransformStore(Box_TransformStore* store) {
+	store->positionX = NULL;
+	store->positionY = NULL;
+	store->motionX = NULL;
+	store->motionY = NULL;
+	store->scaleX = NULL;
+	store->scaleY = NULL;
+	store->nodes = NULL;
+	store->attached = NULL;
+	store->moved = NULL;
+	store->movedCount = 0;
+	store->capacity = 0;
+	store->count = 0;
+}
+
+void Box_freeTransformStore(Box_TransformStore* store) {
+	TOY_FREE_ARRAY(int, store->positionX, store->capacity);
+	TOY_FREE_ARRAY(int, store->positionY, store->capacity);
+	TOY_FREE_ARRAY(int, store->motionX, store->capacity);
+	TOY_FREE_ARRAY(int, store->motionY, store->capacity);
+	TOY_FREE_ARRAY(float, store->scaleX, store->capacity);
+	TOY_FREE_ARRAY(float, store->scaleY, store->capacity);
+	TOY_FREE_ARRAY(Box_Node*, store->nodes, store->capacity);
+	TOY_FREE_ARRAY(int, store->attached, store->capacity);
+	TOY_FREE_ARRAY(int, store->moved, store->capacity);
+
+	Box_initTransformStore(store);
+}
+
+int Box_pushTransformStore(Box_TransformStore* store, Box_Node* node) {
+	if (store->count + 1 > store->capacity) {
+		int oldCapacity = store->capacity;
+
+		store->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		store->positionX = TOY_GROW_ARRAY(int, store->positionX, oldCapacity, store->capacity);
+		store->positionY = TOY_GROW_ARRAY(int, store->positionY, oldCapacity, store->capacity);
+		store->motionX = TOY_GROW_ARRAY(int, store->motionX, oldCapacity, store->capacity);
+		store->motionY = TOY_GROW_ARRAY(int, store->motionY, oldCapacity, store->capacity);
+		store->scaleX = TOY_GROW_ARRAY(float, store->scaleX, oldCapacity, store->capacity);
+		store->scaleY = TOY_GROW_ARRAY(float, store->scaleY, oldCapacity, store->capacity);
+		store->nodes = TOY_GROW_ARRAY(Box_Node*, store->nodes, oldCapacity, store->capacity);
+		store->attached = TOY_GROW_ARRAY(int, store->attached, oldCapacity, store->capacity);
+		store->moved = TOY_GROW_ARRAY(int, store->moved, oldCapacity, store->capacity);
+	}
+
+	int index = store->count++;
+
+	store->positionX[index] = node->positionX;
+	store->positionY[index] = node->positionY;
+	store->motionX[index] = node->motionX;
+	store->motionY[index] = node->motionY;
+	store->scaleX[index] = node->scaleX;
+	store->scaleY[index] = node->scaleY;
+	store->nodes[index] = node;
+	store->attached[index] = 0; //until pushed into the tree
+
+	return index;
+}
+
+void Box_removeTransformStore(Box_TransformStore* store, int index) {
+	int last = --store->count;
+
+	if (index != last) {
+		store->positionX[index] = store->positionX[last];
+		store->positionY[index] = store->positionY[last];
+		store->motionX[index] = store->motionX[last];
+		store->motionY[index] = store->motionY[last];
+		store->scaleX[index] = store->scaleX[last];
+		store->scaleY[index] = store->scaleY[last];
+		store->nodes[index] = store->nodes[last];
+		store->attached[index] = store->attached[last];
+
+		store->nodes[index]->transform = index;
+	}
+}
+
+void Box_integrateTransformStore(Box_TransformStore* store) {
+	int i = 0;
+
+	store->movedCount = 0;
+
+#ifdef __SSE2__
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i + 4 <= store->count; i += 4) {
+		//nodes outside of the tree don't move
+		__m128i mask = _mm_loadu_si128((const __m128i*)&store->attached[i]);
+		__m128i mx = _mm_and_si128(_mm_loadu_si128((const __m128i*)&store->motionX[i]), mask);
+		__m128i my = _mm_and_si128(_mm_loadu_si128((const __m128i*)&store->motionY[i]), mask);
+
+		//skip the blocks where nothing moves
+		int still = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_or_si128(mx, my), zero)));
+		if (still == 0xF) {
+			continue;
+		}
+
+		__m128i px = _mm_loadu_si128((const __m128i*)&store->positionX[i]);
+		__m128i py = _mm_loadu_si128((const __m128i*)&store->positionY[i]);
+
+		_mm_storeu_si128((__m128i*)&store->positionX[i], _mm_add_epi32(px, mx));
+		_mm_storeu_si128((__m128i*)&store->positionY[i], _mm_add_epi32(py, my));
+
+		//only record the moved slots here, to keep the loop tight
+		for (int lane = 0; lane < 4; lane++) {
+			if (!(still & (1 << lane))) {
+				store->moved[store->movedCount++] = i + lane;
+			}
+		}
+	}
+#endif
+
+	//the remainder, or everything without SSE2
+	for (; i < store->count; i++) {
+		if (store->attached[i] && (store->motionX[i] != 0 || store->motionY[i] != 0)) {
+			store->positionX[i] += store->motionX[i];
+			store->positionY[i] += store->motionY[i];
+
+			store->moved[store->movedCount++] = i;
+		}
+	}
+
+	//the moved nodes' world transforms are stale
+	for (int m = 0; m < store->movedCount; m++) {
+		Box_invalidateWorldNode(store->nodes[store->moved[m]]);
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "box_common.h"
+#include "box_node.h"
+
+//node transforms packed into parallel arrays, so the motion step can be vectorized
+typedef struct Box_private_transform_store {
+	int* positionX;
+	int* positionY;
+	int* motionX;
+	int* motionY;
+	float* scaleX;
+	float* scaleY;
+
+	Box_Node** nodes; //the owner of each slot
+	int* attached; //-1 while the owner is reachable from the root node, otherwise 0 - masks the motion step
+	int* moved; //the slots moved by the last motion step, invalidated after it in one pass
+	int movedCount;
+
+	int capacity;
+	int count; //slots are kept dense
+} Box_TransformStore;
+
+BOX_API void Box_initTransformStore(Box_TransformStore* store);
+BOX_API void Box_freeTransformStore(Box_TransformStore* store);
+
+BOX_API int Box_pushTransformStore(Box_TransformStore* store, Box_Node* node); //copy the node's transform into a new slot, and return its index
+BOX_API void Box_removeTransformStore(Box_TransformStore* store, int index); //NOTE: moves the last slot into the gap, updating its owner
+
+BOX_API void Box_integrateTransformStore(Box_TransformStore* store); //move every attached slot's position by its motion
@@ -0,0 +1,146 @@
+#include "box_watcher.h"
+
+#include "toy_memory.h"
+#include "toy_console_colors.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+//the events left by editors saving a file, including those which write a copy and rename it
+#define WATCH_MASK (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE_SELF)
+#endif
+
+//utils
+static void freeFoldersUtil(Box_Watcher* watcher) {
+	for (int i = 0; i < watcher->count; i++) {
+		TOY_FREE_ARRAY(char, watcher->folders[i], strlen(watcher->folders[i]) + 1);
+	}
+
+	TOY_FREE_ARRAY(char*, watcher->folders, watcher->capacity);
+
+	watcher->folders = NULL;
+	watcher->capacity = 0;
+	watcher->count = 0;
+}
+
+//exposed functions
+void Box_initWatcher(Box_Watcher* watcher) {
+	watcher->active = false;
+	watcher->fd = -1;
+	watcher->folders = NULL;
+	watcher->capacity = 0;
+	watcher->count = 0;
+	watcher->changed = false;
+	watcher->nextPoll = 0;
+}
+
+void Box_freeWatcher(Box_Watcher* watcher) {
+	Box_stopWatcher(watcher);
+}
+
+void Box_startWatcher(Box_Watcher* watcher) {
+	if (watcher->active) {
+		return;
+	}
+
+	watcher->active = true;
+	watcher->changed = true; //catch up with anything changed while stopped
+	watcher->nextPoll = 0;
+
+#if defined(__linux__)
+	watcher->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (watcher->fd < 0) {
+		fprintf(stderr, TOY_CC_WARN "Could not start inotify, polling the scripts instead: %s\n" TOY_CC_RESET, strerror(errno));
+	}
+#endif
+}
+
+void Box_stopWatcher(Box_Watcher* watcher) {
+#if defined(__linux__)
+	if (watcher->fd >= 0) {
+		close(watcher->fd); //removes every watch
+	}
+#endif
+
+	watcher->fd = -1;
+	watcher->active = false;
+
+	freeFoldersUtil(watcher);
+}
+
+void Box_watchFileWatcher(Box_Watcher* watcher, const char* filePath) {
+	if (!watcher->active) {
+		return;
+	}
+
+	//the folder, or "." for bare file names
+	const char* slash = strrchr(filePath, '/');
+	size_t length = slash != NULL ? (size_t)(slash - filePath) : 1;
+	const char* folder = slash != NULL ? filePath : ".";
+
+	for (int i = 0; i < watcher->count; i++) {
+		if (strlen(watcher->folders[i]) == length && strncmp(watcher->folders[i], folder, length) == 0) {
+			return;
+		}
+	}
+
+	if (watcher->count + 1 > watcher->capacity) {
+		int oldCapacity = watcher->capacity;
+
+		watcher->capacity = TOY_GROW_CAPACITY(oldCapacity);
+		watcher->folders = TOY_GROW_ARRAY(char*, watcher->folders, oldCapacity, watcher->capacity);
+	}
+
+	char* copy = TOY_ALLOCATE(char, length + 1);
+	memcpy(copy, folder, length);
+	copy[length] = '\0';
+
+	watcher->folders[watcher->count++] = copy;
+
+#if defined(__linux__)
+	//a folder that doesn't exist on disk (such as one inside a pack) never changes
+	if (watcher->fd >= 0 && inotify_add_watch(watcher->fd, copy, WATCH_MASK) < 0 && errno != ENOENT) {
+		fprintf(stderr, TOY_CC_WARN "Could not watch the folder \"%s\": %s\n" TOY_CC_RESET, copy, strerror(errno));
+	}
+#endif
+}
+
+bool Box_pollWatcher(Box_Watcher* watcher) {
+	if (!watcher->active) {
+		return false;
+	}
+
+#if defined(__linux__)
+	if (watcher->fd >= 0) {
+		//only whether anything happened matters, the scripts in use are checked afterwards
+		char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+		while (read(watcher->fd, buffer, sizeof(buffer)) > 0) {
+			watcher->changed = true;
+		}
+
+		bool changed = watcher->changed;
+		watcher->changed = false;
+		return changed;
+	}
+#endif
+
+	//fall back to checking every so often
+	Uint64 now = SDL_GetTicks64();
+
+	if (now < watcher->nextPoll) {
+		return false;
+	}
+
+	watcher->nextPoll = now + BOX_WATCHER_POLL_MILLISECONDS;
+	watcher->changed = false;
+
+	return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "box_common.h"
+
+//without inotify, the scripts in use are checked this often instead
+#define BOX_WATCHER_POLL_MILLISECONDS 500
+
+//notices when the folders of the scripts in use change, for hot-reloading
+typedef struct Box_private_watcher {
+	bool active;
+	int fd; //inotify instance, or -1 when polling
+
+	//the folders being watched
+	char** folders;
+	int capacity;
+	int count;
+
+	bool changed; //something happened since the last poll
+	Uint64 nextPoll; //in milliseconds, when polling
+} Box_Watcher;
+
+BOX_API void Box_initWatcher(Box_Watcher* watcher); //inactive until started
+BOX_API void Box_freeWatcher(Box_Watcher* watcher);
+
+BOX_API void Box_startWatcher(Box_Watcher* watcher);
+BOX_API void Box_stopWatcher(Box_Watcher* watcher); //forgets the watched folders
+
+BOX_API void Box_watchFileWatcher(Box_Watcher* watcher, const char* filePath); //watches the folder holding filePath, once
+BOX_API bool Box_pollWatcher(Box_Watcher* watcher); //true if the watched files might have changed since the last poll
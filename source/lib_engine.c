@@ -1,6 +1,7 @@
 #include "lib_engine.h"
 
 #include "box_engine.h"
+#include "box_pack.h"
 
 #include "repl_tools.h"
 #include "drive_system.h"
@@ -20,7 +21,7 @@ static void fatalError(char* message) {
 
 //native functions to be called
 static int nativeInitWindow(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
-	if (engine.window != NULL) {
+	if (engine.window != NULL || engine.renderer != NULL) {
 		fatalError("Can't re-initialize the window\n");
 	}
 
@@ -59,6 +60,33 @@ static int nativeInitWindow(Toy_Interpreter* interpreter, Toy_LiteralArray* argu
 		fatalError("Incorrect argument type passed to initWindow\n");
 	}
 
+	//headless runs render to memory instead, so scripts and textures still work
+	if (engine.headless) {
+		engine.screenWidth = TOY_AS_INTEGER(screenWidth);
+		engine.screenHeight = TOY_AS_INTEGER(screenHeight);
+
+		engine.headlessSurface = SDL_CreateRGBSurfaceWithFormat(0, engine.screenWidth, engine.screenHeight, 32, SDL_PIXELFORMAT_RGBA32);
+
+		if (engine.headlessSurface == NULL) {
+			fatalError("Failed to initialize the headless surface\n");
+		}
+
+		engine.renderer = SDL_CreateSoftwareRenderer(engine.headlessSurface);
+
+		if (engine.renderer == NULL) {
+			fatalError("Failed to initialize the headless renderer\n");
+		}
+
+		engine.running = true;
+
+		Toy_freeLiteral(caption);
+		Toy_freeLiteral(screenWidth);
+		Toy_freeLiteral(screenHeight);
+		Toy_freeLiteral(fscreen);
+
+		return 0;
+	}
+
 	//init the window
 	engine.window = SDL_CreateWindow(
 		Toy_toCString(TOY_AS_STRING(caption)),
@@ -75,7 +103,7 @@ static int nativeInitWindow(Toy_Interpreter* interpreter, Toy_LiteralArray* argu
 
 	//init the renderer
 	// SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
-	engine.renderer = SDL_CreateRenderer(engine.window, -1, SDL_RENDERER_ACCELERATED);
+	engine.renderer = SDL_CreateRenderer(engine.window, -1, SDL_RENDERER_ACCELERATED | (engine.pacer.vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
 
 	if (engine.renderer == NULL) {
 		fatalError("Failed to initialize the renderer\n");
@@ -101,23 +129,90 @@ static int nativeInitWindow(Toy_Interpreter* interpreter, Toy_LiteralArray* argu
 }
 
 static int nativeLoadRootNode(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
-	if (arguments->count != 1) {
+	if (arguments->count != 1 && arguments->count != 2) {
 		interpreter->errorOutput("Incorrect number of arguments passed to loadRootNode\n");
 		return -1;
 	}
 
 	//extract the arguments
+	Toy_Literal asyncLiteral = arguments->count == 2 ? Toy_popLiteralArray(arguments) : TOY_TO_BOOLEAN_LITERAL(false);
 	Toy_Literal drivePathLiteral = Toy_popLiteralArray(arguments);
 
+	Toy_Literal asyncLiteralIdn = asyncLiteral;
+	if (TOY_IS_IDENTIFIER(asyncLiteral) && Toy_parseIdentifierToValue(interpreter, &asyncLiteral)) {
+		Toy_freeLiteral(asyncLiteralIdn);
+	}
+
 	Toy_Literal drivePathLiteralIdn = drivePathLiteral;
 	if (TOY_IS_IDENTIFIER(drivePathLiteral) && Toy_parseIdentifierToValue(interpreter, &drivePathLiteral)) {
 		Toy_freeLiteral(drivePathLiteralIdn);
 	}
 
 	//check argument types
-	if (!TOY_IS_STRING(drivePathLiteral)) {
+	if (!TOY_IS_STRING(drivePathLiteral) || !TOY_IS_BOOLEAN(asyncLiteral)) {
 		interpreter->errorOutput("Incorrect argument type passed to loadRootNode\n");
 		Toy_freeLiteral(drivePathLiteral);
+		Toy_freeLiteral(asyncLiteral);
+		return -1;
+	}
+
+	bool async = TOY_AS_BOOLEAN(asyncLiteral);
+	Toy_freeLiteral(asyncLiteral);
+
+	Toy_Literal filePathLiteral = Toy_getDrivePathLiteral(interpreter, &drivePathLiteral);
+
+	Toy_freeLiteral(drivePathLiteral); //not needed anymore
+
+	if (!TOY_IS_STRING(filePathLiteral)) {
+		Toy_freeLiteral(filePathLiteral);
+		return -1;
+	}
+
+	//the latest call wins
+	if (!TOY_IS_NULL(engine.nextRootNodeFilename)) {
+		Toy_freeLiteral(engine.nextRootNodeFilename);
+		engine.nextRootNodeFilename = TOY_TO_NULL_LITERAL;
+	}
+
+	if (!TOY_IS_NULL(engine.pendingRootNodeFilename)) {
+		Toy_freeLiteral(engine.pendingRootNodeFilename);
+		engine.pendingRootNodeFilename = TOY_TO_NULL_LITERAL;
+	}
+
+	if (async) {
+		//compile it and its child scripts in the background, then swap once they're ready
+		engine.pendingRootNodeFilename = Toy_copyLiteral(filePathLiteral);
+		Box_startLoader(&engine.loader, filePathLiteral);
+	}
+	else {
+		//set the signal that a new node is needed
+		Box_clearLoader(&engine.loader);
+		engine.nextRootNodeFilename = Toy_copyLiteral(filePathLiteral);
+	}
+
+	Toy_freeLiteral(filePathLiteral);
+
+	return 0;
+}
+
+static int nativeMountPack(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to mountPack\n");
+		return -1;
+	}
+
+	//extract the arguments
+	Toy_Literal drivePathLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal drivePathLiteralIdn = drivePathLiteral;
+	if (TOY_IS_IDENTIFIER(drivePathLiteral) && Toy_parseIdentifierToValue(interpreter, &drivePathLiteral)) {
+		Toy_freeLiteral(drivePathLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_STRING(drivePathLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to mountPack\n");
+		Toy_freeLiteral(drivePathLiteral);
 		return -1;
 	}
 
@@ -130,14 +225,33 @@ static int nativeLoadRootNode(Toy_Interpreter* interpreter, Toy_LiteralArray* ar
 		return -1;
 	}
 
-	//set the signal that a new node is needed
-	engine.nextRootNodeFilename = Toy_copyLiteral(filePathLiteral);
+	//files already loaded are unaffected
+	if (Box_mountPack(Toy_toCString(TOY_AS_STRING(filePathLiteral))) != 0) {
+		interpreter->errorOutput("Failed to mount the pack in mountPack\n");
+		Toy_freeLiteral(filePathLiteral);
+		return -1;
+	}
 
 	Toy_freeLiteral(filePathLiteral);
 
 	return 0;
 }
 
+static int nativeGetRootNodeProgress(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 0) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getRootNodeProgress\n");
+		return -1;
+	}
+
+	float progress = TOY_IS_NULL(engine.pendingRootNodeFilename) ? 1.0f : Box_getProgressLoader(&engine.loader);
+
+	Toy_Literal progressLiteral = TOY_TO_FLOAT_LITERAL(progress);
+	Toy_pushLiteralArray(&interpreter->stack, progressLiteral);
+	Toy_freeLiteral(progressLiteral);
+
+	return 1;
+}
+
 static int nativeGetRootNode(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
 	if (arguments->count != 0) {
 		interpreter->errorOutput("Incorrect number of arguments passed to getRootNode\n");
@@ -177,6 +291,9 @@ static int nativeSetRenderTarget(Toy_Interpreter* interpreter, Toy_LiteralArray*
 		Toy_freeLiteral(nodeLiteral);
 	}
 
+	//draw everything queued for the old target first
+	Box_flushSpriteBatch(&engine.spriteBatch, engine.renderer);
+
 	if (TOY_IS_NULL(nodeLiteral)) {
 		SDL_SetRenderTarget(engine.renderer, NULL);
 	}
@@ -190,6 +307,542 @@ static int nativeSetRenderTarget(Toy_Interpreter* interpreter, Toy_LiteralArray*
 	return 0;
 }
 
+static int nativeSetLayerTextureGrouping(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 2) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setLayerTextureGrouping\n");
+		return -1;
+	}
+
+	Toy_Literal groupedLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal layerLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal layerLiteralIdn = layerLiteral;
+	if (TOY_IS_IDENTIFIER(layerLiteral) && Toy_parseIdentifierToValue(interpreter, &layerLiteral)) {
+		Toy_freeLiteral(layerLiteralIdn);
+	}
+
+	Toy_Literal groupedLiteralIdn = groupedLiteral;
+	if (TOY_IS_IDENTIFIER(groupedLiteral) && Toy_parseIdentifierToValue(interpreter, &groupedLiteral)) {
+		Toy_freeLiteral(groupedLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_INTEGER(layerLiteral) || !TOY_IS_BOOLEAN(groupedLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to setLayerTextureGrouping\n");
+		Toy_freeLiteral(layerLiteral);
+		Toy_freeLiteral(groupedLiteral);
+		return -1;
+	}
+
+	//sprites within a grouped layer can be drawn out of order, to save draw calls
+	Box_setGroupedLayerSpriteBatch(&engine.spriteBatch, TOY_AS_INTEGER(layerLiteral), TOY_AS_BOOLEAN(groupedLiteral));
+
+	Toy_freeLiteral(layerLiteral);
+	Toy_freeLiteral(groupedLiteral);
+
+	return 0;
+}
+
+
+//debugging functions
+static int nativeGetBytecodeCacheHits(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 0) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getBytecodeCacheHits\n");
+		return -1;
+	}
+
+	Toy_Literal resultLiteral = TOY_TO_INTEGER_LITERAL(Box_getHitsBytecodeCache(&engine.bytecodeCache));
+
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	Toy_freeLiteral(resultLiteral);
+
+	return 1;
+}
+
+static int nativeGetBytecodeCacheMisses(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 0) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getBytecodeCacheMisses\n");
+		return -1;
+	}
+
+	Toy_Literal resultLiteral = TOY_TO_INTEGER_LITERAL(Box_getMissesBytecodeCache(&engine.bytecodeCache));
+
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	Toy_freeLiteral(resultLiteral);
+
+	return 1;
+}
+
+static int nativeGetBytecodeCacheReloads(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 0) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getBytecodeCacheReloads\n");
+		return -1;
+	}
+
+	Toy_Literal resultLiteral = TOY_TO_INTEGER_LITERAL(Box_getReloadsBytecodeCache(&engine.bytecodeCache));
+
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	Toy_freeLiteral(resultLiteral);
+
+	return 1;
+}
+
+static int nativeGetEventQueueDepth(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 0) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getEventQueueDepth\n");
+		return -1;
+	}
+
+	//the events waiting for the next drain
+	Toy_Literal resultLiteral = TOY_TO_INTEGER_LITERAL(engine.dispatcher.queueCount);
+
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	Toy_freeLiteral(resultLiteral);
+
+	return 1;
+}
+
+static int nativeGetEventsDrained(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 0) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getEventsDrained\n");
+		return -1;
+	}
+
+	//the number of events delivered by the last drain
+	Toy_Literal resultLiteral = TOY_TO_INTEGER_LITERAL(engine.dispatcher.drainedCount);
+
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	Toy_freeLiteral(resultLiteral);
+
+	return 1;
+}
+
+static int nativeGetEventDrainTime(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 0) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getEventDrainTime\n");
+		return -1;
+	}
+
+	//in milliseconds
+	Toy_Literal resultLiteral = TOY_TO_FLOAT_LITERAL(engine.dispatcher.drainMilliseconds);
+
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	Toy_freeLiteral(resultLiteral);
+
+	return 1;
+}
+
+static int nativeSetHotReload(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setHotReload\n");
+		return -1;
+	}
+
+	Toy_Literal enabledLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal enabledLiteralIdn = enabledLiteral;
+	if (TOY_IS_IDENTIFIER(enabledLiteral) && Toy_parseIdentifierToValue(interpreter, &enabledLiteral)) {
+		Toy_freeLiteral(enabledLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_BOOLEAN(enabledLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to setHotReload\n");
+		Toy_freeLiteral(enabledLiteral);
+		return -1;
+	}
+
+	//watch the folders of the scripts as they're compiled
+	if (TOY_AS_BOOLEAN(enabledLiteral)) {
+		Box_startWatcher(&engine.watcher);
+		Box_setWatcherBytecodeCache(&engine.bytecodeCache, &engine.watcher);
+	}
+	else {
+		Box_setWatcherBytecodeCache(&engine.bytecodeCache, NULL);
+		Box_stopWatcher(&engine.watcher);
+	}
+
+	Toy_freeLiteral(enabledLiteral);
+
+	return 0;
+}
+
+static int nativeSetPackedTransforms(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setPackedTransforms\n");
+		return -1;
+	}
+
+	Toy_Literal enabledLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal enabledLiteralIdn = enabledLiteral;
+	if (TOY_IS_IDENTIFIER(enabledLiteral) && Toy_parseIdentifierToValue(interpreter, &enabledLiteral)) {
+		Toy_freeLiteral(enabledLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_BOOLEAN(enabledLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to setPackedTransforms\n");
+		Toy_freeLiteral(enabledLiteral);
+		return -1;
+	}
+
+	//existing nodes would be skipped by the packed motion step
+	if (engine.rootNode != NULL) {
+		interpreter->errorOutput("Can't change the transform storage after the root node is loaded\n");
+		Toy_freeLiteral(enabledLiteral);
+		return -1;
+	}
+
+	engine.packedTransforms = TOY_AS_BOOLEAN(enabledLiteral);
+
+	Toy_freeLiteral(enabledLiteral);
+
+	return 0;
+}
+
+static int nativeSetTextureAtlas(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setTextureAtlas\n");
+		return -1;
+	}
+
+	Toy_Literal enabledLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal enabledLiteralIdn = enabledLiteral;
+	if (TOY_IS_IDENTIFIER(enabledLiteral) && Toy_parseIdentifierToValue(interpreter, &enabledLiteral)) {
+		Toy_freeLiteral(enabledLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_BOOLEAN(enabledLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to setTextureAtlas\n");
+		Toy_freeLiteral(enabledLiteral);
+		return -1;
+	}
+
+	//pack small images into shared textures from now on
+	engine.textureCache.atlasEnabled = TOY_AS_BOOLEAN(enabledLiteral);
+
+	Toy_freeLiteral(enabledLiteral);
+
+	return 0;
+}
+
+static int nativeSetTargetFrameRate(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setTargetFrameRate\n");
+		return -1;
+	}
+
+	Toy_Literal fpsLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal fpsLiteralIdn = fpsLiteral;
+	if (TOY_IS_IDENTIFIER(fpsLiteral) && Toy_parseIdentifierToValue(interpreter, &fpsLiteral)) {
+		Toy_freeLiteral(fpsLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_INTEGER(fpsLiteral) || TOY_AS_INTEGER(fpsLiteral) < 0) {
+		interpreter->errorOutput("Incorrect argument type passed to setTargetFrameRate\n");
+		Toy_freeLiteral(fpsLiteral);
+		return -1;
+	}
+
+	//0 means uncapped
+	Box_setTargetFramePacer(&engine.pacer, TOY_AS_INTEGER(fpsLiteral));
+
+	Toy_freeLiteral(fpsLiteral);
+
+	return 0;
+}
+
+static int nativeSetVSync(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setVSync\n");
+		return -1;
+	}
+
+	Toy_Literal enabledLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal enabledLiteralIdn = enabledLiteral;
+	if (TOY_IS_IDENTIFIER(enabledLiteral) && Toy_parseIdentifierToValue(interpreter, &enabledLiteral)) {
+		Toy_freeLiteral(enabledLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_BOOLEAN(enabledLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to setVSync\n");
+		Toy_freeLiteral(enabledLiteral);
+		return -1;
+	}
+
+	engine.pacer.vsync = TOY_AS_BOOLEAN(enabledLiteral);
+
+	//applied when the window is created, if it doesn't exist yet
+	if (engine.window != NULL) {
+		SDL_RenderSetVSync(engine.renderer, engine.pacer.vsync ? 1 : 0);
+	}
+
+	Toy_freeLiteral(enabledLiteral);
+
+	return 0;
+}
+
+static int nativeGetMissedFrames(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 0) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getMissedFrames\n");
+		return -1;
+	}
+
+	Toy_Literal resultLiteral = TOY_TO_INTEGER_LITERAL(Box_getMissedFramesFramePacer(&engine.pacer));
+
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	Toy_freeLiteral(resultLiteral);
+
+	return 1;
+}
+
+static int nativeSetStepRate(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setStepRate\n");
+		return -1;
+	}
+
+	Toy_Literal rateLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal rateLiteralIdn = rateLiteral;
+	if (TOY_IS_IDENTIFIER(rateLiteral) && Toy_parseIdentifierToValue(interpreter, &rateLiteral)) {
+		Toy_freeLiteral(rateLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_INTEGER(rateLiteral) || TOY_AS_INTEGER(rateLiteral) <= 0) {
+		interpreter->errorOutput("Incorrect argument type passed to setStepRate\n");
+		Toy_freeLiteral(rateLiteral);
+		return -1;
+	}
+
+	engine.stepRate = TOY_AS_INTEGER(rateLiteral);
+
+	Toy_freeLiteral(rateLiteral);
+
+	return 0;
+}
+
+static int nativeSetMaxStepsPerFrame(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 2) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setMaxStepsPerFrame\n");
+		return -1;
+	}
+
+	Toy_Literal carryLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal stepsLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal stepsLiteralIdn = stepsLiteral;
+	if (TOY_IS_IDENTIFIER(stepsLiteral) && Toy_parseIdentifierToValue(interpreter, &stepsLiteral)) {
+		Toy_freeLiteral(stepsLiteralIdn);
+	}
+
+	Toy_Literal carryLiteralIdn = carryLiteral;
+	if (TOY_IS_IDENTIFIER(carryLiteral) && Toy_parseIdentifierToValue(interpreter, &carryLiteral)) {
+		Toy_freeLiteral(carryLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_INTEGER(stepsLiteral) || TOY_AS_INTEGER(stepsLiteral) < 0 || !TOY_IS_BOOLEAN(carryLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to setMaxStepsPerFrame\n");
+		Toy_freeLiteral(stepsLiteral);
+		Toy_freeLiteral(carryLiteral);
+		return -1;
+	}
+
+	//0 means no limit
+	engine.maxStepsPerFrame = TOY_AS_INTEGER(stepsLiteral);
+	engine.carryTimeDebt = TOY_AS_BOOLEAN(carryLiteral);
+
+	Toy_freeLiteral(stepsLiteral);
+	Toy_freeLiteral(carryLiteral);
+
+	return 0;
+}
+
+static int nativeGetInterpolationAlpha(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 0) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getInterpolationAlpha\n");
+		return -1;
+	}
+
+	Toy_Literal resultLiteral = TOY_TO_FLOAT_LITERAL(engine.interpolationAlpha);
+
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	Toy_freeLiteral(resultLiteral);
+
+	return 1;
+}
+
+static int nativeLoadTextureAsync(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count != 1 && arguments->count != 2) {
+		interpreter->errorOutput("Incorrect number of arguments passed to loadTextureAsync\n");
+		return -1;
+	}
+
+	//get the filename, and the optional callback
+	Toy_Literal callbackLiteral = arguments->count == 2 ? Toy_popLiteralArray(arguments) : TOY_TO_NULL_LITERAL;
+	Toy_Literal fileLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal callbackLiteralIdn = callbackLiteral;
+	if (TOY_IS_IDENTIFIER(callbackLiteral) && Toy_parseIdentifierToValue(interpreter, &callbackLiteral)) {
+		Toy_freeLiteral(callbackLiteralIdn);
+	}
+
+	Toy_Literal fileLiteralIdn = fileLiteral;
+	if (TOY_IS_IDENTIFIER(fileLiteral) && Toy_parseIdentifierToValue(interpreter, &fileLiteral)) {
+		Toy_freeLiteral(fileLiteralIdn);
+	}
+
+	if (!TOY_IS_STRING(fileLiteral) || !(TOY_IS_NULL(callbackLiteral) || TOY_IS_FUNCTION(callbackLiteral))) {
+		interpreter->errorOutput("Incorrect argument type passed to loadTextureAsync\n");
+		Toy_freeLiteral(fileLiteral);
+		Toy_freeLiteral(callbackLiteral);
+		return -1;
+	}
+
+	//get the path
+	Toy_Literal pathLiteral = Toy_getDrivePathLiteral(interpreter, &fileLiteral);
+
+	if (TOY_IS_NULL(pathLiteral)) {
+		Toy_freeLiteral(fileLiteral);
+		Toy_freeLiteral(callbackLiteral);
+		Toy_freeLiteral(pathLiteral);
+		return -1;
+	}
+
+	//decoded by a worker, then kept in the texture cache, so loadNodeTexture() finds it
+	Box_Asset* asset = Box_requestAssetLoader(&engine.assetLoader, BOX_ASSET_TEXTURE, pathLiteral, callbackLiteral);
+
+	//return the handle
+	Toy_Literal assetLiteral = TOY_TO_OPAQUE_LITERAL(asset, BOX_OPAQUE_TAG_ASSET);
+
+	Toy_pushLiteralArray(&interpreter->stack, assetLiteral);
+
+	Toy_freeLiteral(fileLiteral);
+	Toy_freeLiteral(callbackLiteral);
+	Toy_freeLiteral(pathLiteral);
+	Toy_freeLiteral(assetLiteral);
+
+	return 1;
+}
+
+static int nativeGetAssetState(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getAssetState\n");
+		return -1;
+	}
+
+	//get the asset
+	Toy_Literal assetLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal assetLiteralIdn = assetLiteral;
+	if (TOY_IS_IDENTIFIER(assetLiteral) && Toy_parseIdentifierToValue(interpreter, &assetLiteral)) {
+		Toy_freeLiteral(assetLiteralIdn);
+	}
+
+	if (!TOY_IS_OPAQUE(assetLiteral) || TOY_GET_OPAQUE_TAG(assetLiteral) != BOX_OPAQUE_TAG_ASSET) {
+		interpreter->errorOutput("Incorrect argument type passed to getAssetState\n");
+		Toy_freeLiteral(assetLiteral);
+		return -1;
+	}
+
+	Box_Asset* asset = TOY_AS_OPAQUE(assetLiteral);
+
+	const char* state = "loading";
+
+	switch(asset->state) {
+		case BOX_ASSET_LOADING: state = "loading"; break;
+		case BOX_ASSET_READY: state = "ready"; break;
+		case BOX_ASSET_FAILED: state = "failed"; break;
+	}
+
+	Toy_Literal resultLiteral = TOY_TO_STRING_LITERAL(Toy_createRefString(state));
+
+	//return the value
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	Toy_freeLiteral(resultLiteral);
+	Toy_freeLiteral(assetLiteral);
+
+	return 1;
+}
+
+static int nativeFreeAsset(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to freeAsset\n");
+		return -1;
+	}
+
+	//get the asset
+	Toy_Literal assetLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal assetLiteralIdn = assetLiteral;
+	if (TOY_IS_IDENTIFIER(assetLiteral) && Toy_parseIdentifierToValue(interpreter, &assetLiteral)) {
+		Toy_freeLiteral(assetLiteralIdn);
+	}
+
+	if (!TOY_IS_OPAQUE(assetLiteral) || TOY_GET_OPAQUE_TAG(assetLiteral) != BOX_OPAQUE_TAG_ASSET) {
+		interpreter->errorOutput("Incorrect argument type passed to freeAsset\n");
+		Toy_freeLiteral(assetLiteral);
+		return -1;
+	}
+
+	Box_Asset* asset = TOY_AS_OPAQUE(assetLiteral);
+
+	//an unclaimed sound, or a texture kept in the cache, is freed with it
+	Box_releaseAssetLoader(&engine.assetLoader, asset);
+
+	Toy_freeLiteral(assetLiteral);
+
+	return 0;
+}
+
+static int nativeSetAssetUploadBudget(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setAssetUploadBudget\n");
+		return -1;
+	}
+
+	Toy_Literal budgetLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal budgetLiteralIdn = budgetLiteral;
+	if (TOY_IS_IDENTIFIER(budgetLiteral) && Toy_parseIdentifierToValue(interpreter, &budgetLiteral)) {
+		Toy_freeLiteral(budgetLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_INTEGER(budgetLiteral) || TOY_AS_INTEGER(budgetLiteral) < 1) {
+		interpreter->errorOutput("Incorrect argument type passed to setAssetUploadBudget\n");
+		Toy_freeLiteral(budgetLiteral);
+		return -1;
+	}
+
+	//textures created per frame, by the async loads
+	engine.assetLoader.uploadBudget = TOY_AS_INTEGER(budgetLiteral);
+
+	Toy_freeLiteral(budgetLiteral);
+
+	return 0;
+}
 
 //call the hook
 typedef struct Natives {
@@ -203,7 +856,29 @@ int Box_hookEngine(Toy_Interpreter* interpreter, Toy_Literal identifier, Toy_Lit
 		{"initWindow", nativeInitWindow},
 		{"loadRootNode", nativeLoadRootNode},
 		{"getRootNode", nativeGetRootNode},
+		{"getRootNodeProgress", nativeGetRootNodeProgress},
+		{"mountPack", nativeMountPack},
 		{"setRenderTarget", nativeSetRenderTarget},
+		{"setLayerTextureGrouping", nativeSetLayerTextureGrouping},
+		{"getBytecodeCacheHits", nativeGetBytecodeCacheHits},
+		{"getBytecodeCacheMisses", nativeGetBytecodeCacheMisses},
+		{"getBytecodeCacheReloads", nativeGetBytecodeCacheReloads},
+		{"setHotReload", nativeSetHotReload},
+		{"getEventQueueDepth", nativeGetEventQueueDepth},
+		{"getEventsDrained", nativeGetEventsDrained},
+		{"getEventDrainTime", nativeGetEventDrainTime},
+		{"setPackedTransforms", nativeSetPackedTransforms},
+		{"setTextureAtlas", nativeSetTextureAtlas},
+		{"setTargetFrameRate", nativeSetTargetFrameRate},
+		{"setVSync", nativeSetVSync},
+		{"getMissedFrames", nativeGetMissedFrames},
+		{"setStepRate", nativeSetStepRate},
+		{"setMaxStepsPerFrame", nativeSetMaxStepsPerFrame},
+		{"getInterpolationAlpha", nativeGetInterpolationAlpha},
+		{"loadTextureAsync", nativeLoadTextureAsync},
+		{"getAssetState", nativeGetAssetState},
+		{"freeAsset", nativeFreeAsset},
+		{"setAssetUploadBudget", nativeSetAssetUploadBudget},
 		{NULL, NULL}
 	};
 
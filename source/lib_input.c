@@ -5,6 +5,8 @@
 
 #include "toy_memory.h"
 
+#include <string.h>
+
 static int nativeMapInputEventToKey(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments, Toy_LiteralDictionary* symKeyEventsPtr, char* fnName) {
 	//checks
 	if (arguments->count != 2) {
@@ -64,6 +66,263 @@ static int nativeMapInputEventToKeyUp(Toy_Interpreter* interpreter, Toy_LiteralA
 	return nativeMapInputEventToKey(interpreter, arguments, &engine.symKeyUpEvents, "mapInputEventToKeyUp");
 }
 
+static int nativeBindAction(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count != 3) {
+		interpreter->errorOutput("Incorrect number of arguments passed to bindAction\n");
+		return -1;
+	}
+
+	Toy_Literal inputLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal deviceLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal actionLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal actionLiteralIdn = actionLiteral;
+	if (TOY_IS_IDENTIFIER(actionLiteral) && Toy_parseIdentifierToValue(interpreter, &actionLiteral)) {
+		Toy_freeLiteral(actionLiteralIdn);
+	}
+
+	Toy_Literal deviceLiteralIdn = deviceLiteral;
+	if (TOY_IS_IDENTIFIER(deviceLiteral) && Toy_parseIdentifierToValue(interpreter, &deviceLiteral)) {
+		Toy_freeLiteral(deviceLiteralIdn);
+	}
+
+	Toy_Literal inputLiteralIdn = inputLiteral;
+	if (TOY_IS_IDENTIFIER(inputLiteral) && Toy_parseIdentifierToValue(interpreter, &inputLiteral)) {
+		Toy_freeLiteral(inputLiteralIdn);
+	}
+
+	if (!TOY_IS_STRING(actionLiteral) || !TOY_IS_STRING(deviceLiteral) || !TOY_IS_STRING(inputLiteral)) {
+		interpreter->errorOutput("Incorrect argument types passed to bindAction\n");
+		Toy_freeLiteral(actionLiteral);
+		Toy_freeLiteral(deviceLiteral);
+		Toy_freeLiteral(inputLiteral);
+		return -1;
+	}
+
+	const char* device = Toy_toCString(TOY_AS_STRING(deviceLiteral));
+	const char* input = Toy_toCString(TOY_AS_STRING(inputLiteral));
+
+	Box_ActionSource source = BOX_ACTION_SOURCE_KEY;
+	int code = -1;
+	int direction = 1;
+
+	//find the input, by the names SDL uses
+	if (!strcmp(device, "key")) {
+		SDL_Keycode keycode = SDL_GetKeyFromName(input);
+		code = keycode != SDLK_UNKNOWN ? (int)keycode : -1;
+	}
+	else if (!strcmp(device, "mouse")) {
+		source = BOX_ACTION_SOURCE_MOUSE_BUTTON;
+
+		for (int i = SDL_BUTTON_LEFT; i <= SDL_BUTTON_X2; i++) {
+			if (!strcmp(input, Toy_toCString(TOY_AS_STRING(engine.mouseButtonNames[i])))) {
+				code = i;
+			}
+		}
+	}
+	else if (!strcmp(device, "gamepad")) {
+		source = BOX_ACTION_SOURCE_GAMEPAD_BUTTON;
+		code = (int)SDL_GameControllerGetButtonFromString(input);
+	}
+	else if (!strcmp(device, "axis")) {
+		//sticks take a direction, such as "leftx-", while triggers only go one way
+		char name[32];
+		size_t length = strlen(input);
+
+		if (length > 0 && (input[length - 1] == '+' || input[length - 1] == '-')) {
+			direction = input[length - 1] == '-' ? -1 : 1;
+			length--;
+		}
+
+		if (length < sizeof(name)) {
+			memcpy(name, input, length);
+			name[length] = '\0';
+
+			source = BOX_ACTION_SOURCE_GAMEPAD_AXIS;
+			code = (int)SDL_GameControllerGetAxisFromString(name);
+		}
+	}
+	else {
+		interpreter->errorOutput("Unknown device passed to bindAction (expected \"key\", \"mouse\", \"gamepad\" or \"axis\"): ");
+		interpreter->errorOutput(device);
+		interpreter->errorOutput("\n");
+		Toy_freeLiteral(actionLiteral);
+		Toy_freeLiteral(deviceLiteral);
+		Toy_freeLiteral(inputLiteral);
+		return -1;
+	}
+
+	if (code < 0) {
+		interpreter->errorOutput("Unknown input passed to bindAction: ");
+		interpreter->errorOutput(input);
+		interpreter->errorOutput("\n");
+		Toy_freeLiteral(actionLiteral);
+		Toy_freeLiteral(deviceLiteral);
+		Toy_freeLiteral(inputLiteral);
+		return -1;
+	}
+
+	int action = Box_findActionMap(&engine.actionMap, actionLiteral, true);
+
+	if (action < 0) {
+		interpreter->errorOutput("Too many actions, can't bind another\n");
+		Toy_freeLiteral(actionLiteral);
+		Toy_freeLiteral(deviceLiteral);
+		Toy_freeLiteral(inputLiteral);
+		return -1;
+	}
+
+	Box_bindActionMap(&engine.actionMap, action, source, code, direction);
+
+	//cleanup
+	Toy_freeLiteral(actionLiteral);
+	Toy_freeLiteral(deviceLiteral);
+	Toy_freeLiteral(inputLiteral);
+
+	return 0;
+}
+
+static int nativeUnbindAction(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to unbindAction\n");
+		return -1;
+	}
+
+	Toy_Literal actionLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal actionLiteralIdn = actionLiteral;
+	if (TOY_IS_IDENTIFIER(actionLiteral) && Toy_parseIdentifierToValue(interpreter, &actionLiteral)) {
+		Toy_freeLiteral(actionLiteralIdn);
+	}
+
+	if (!TOY_IS_STRING(actionLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to unbindAction\n");
+		Toy_freeLiteral(actionLiteral);
+		return -1;
+	}
+
+	//the action keeps its index, so it can be bound again
+	int action = Box_findActionMap(&engine.actionMap, actionLiteral, false);
+
+	if (action >= 0) {
+		Box_unbindActionMap(&engine.actionMap, action);
+	}
+
+	Toy_freeLiteral(actionLiteral);
+
+	return 0;
+}
+
+//the kinds of action queries
+typedef enum ActionQuery {
+	ACTION_QUERY_HELD,
+	ACTION_QUERY_PRESSED,
+	ACTION_QUERY_RELEASED,
+	ACTION_QUERY_VALUE,
+} ActionQuery;
+
+static int nativeQueryAction(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments, ActionQuery query, char* fnName) {
+	//checks
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to ");
+		interpreter->errorOutput(fnName);
+		interpreter->errorOutput("\n");
+		return -1;
+	}
+
+	Toy_Literal actionLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal actionLiteralIdn = actionLiteral;
+	if (TOY_IS_IDENTIFIER(actionLiteral) && Toy_parseIdentifierToValue(interpreter, &actionLiteral)) {
+		Toy_freeLiteral(actionLiteralIdn);
+	}
+
+	if (!TOY_IS_STRING(actionLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to ");
+		interpreter->errorOutput(fnName);
+		interpreter->errorOutput("\n");
+		Toy_freeLiteral(actionLiteral);
+		return -1;
+	}
+
+	//actions without bindings are never active
+	int action = Box_findActionMap(&engine.actionMap, actionLiteral, false);
+	Toy_Literal resultLiteral = TOY_TO_NULL_LITERAL;
+
+	switch(query) {
+		case ACTION_QUERY_HELD:
+			resultLiteral = TOY_TO_BOOLEAN_LITERAL(action >= 0 && Box_isHeldActionMap(&engine.actionMap, action));
+			break;
+
+		case ACTION_QUERY_PRESSED:
+			resultLiteral = TOY_TO_BOOLEAN_LITERAL(action >= 0 && Box_isPressedActionMap(&engine.actionMap, action));
+			break;
+
+		case ACTION_QUERY_RELEASED:
+			resultLiteral = TOY_TO_BOOLEAN_LITERAL(action >= 0 && Box_isReleasedActionMap(&engine.actionMap, action));
+			break;
+
+		case ACTION_QUERY_VALUE:
+			resultLiteral = TOY_TO_FLOAT_LITERAL(action >= 0 ? Box_getValueActionMap(&engine.actionMap, action) : 0.0f);
+			break;
+	}
+
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	//cleanup
+	Toy_freeLiteral(actionLiteral);
+	Toy_freeLiteral(resultLiteral);
+
+	return 1;
+}
+
+//dry wrappers
+static int nativeIsActionHeld(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	return nativeQueryAction(interpreter, arguments, ACTION_QUERY_HELD, "isActionHeld");
+}
+
+static int nativeIsActionPressed(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	return nativeQueryAction(interpreter, arguments, ACTION_QUERY_PRESSED, "isActionPressed");
+}
+
+static int nativeIsActionReleased(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	return nativeQueryAction(interpreter, arguments, ACTION_QUERY_RELEASED, "isActionReleased");
+}
+
+static int nativeGetActionValue(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	return nativeQueryAction(interpreter, arguments, ACTION_QUERY_VALUE, "getActionValue");
+}
+
+static int nativeSetRawMouseMotion(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setRawMouseMotion\n");
+		return -1;
+	}
+
+	Toy_Literal enabledLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal enabledLiteralIdn = enabledLiteral;
+	if (TOY_IS_IDENTIFIER(enabledLiteral) && Toy_parseIdentifierToValue(interpreter, &enabledLiteral)) {
+		Toy_freeLiteral(enabledLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_BOOLEAN(enabledLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to setRawMouseMotion\n");
+		Toy_freeLiteral(enabledLiteral);
+		return -1;
+	}
+
+	//every motion event is delivered, instead of one per frame
+	engine.rawMouseMotion = TOY_AS_BOOLEAN(enabledLiteral);
+
+	Toy_freeLiteral(enabledLiteral);
+
+	return 0;
+}
+
 //call the hook
 typedef struct Natives {
 	char* name;
@@ -75,6 +334,13 @@ int Box_hookInput(Toy_Interpreter* interpreter, Toy_Literal identifier, Toy_Lite
 	Natives natives[] = {
 		{"mapInputEventToKeyDown", nativeMapInputEventToKeyDown},
 		{"mapInputEventToKeyUp", nativeMapInputEventToKeyUp},
+		{"setRawMouseMotion", nativeSetRawMouseMotion},
+		{"bindAction", nativeBindAction},
+		{"unbindAction", nativeUnbindAction},
+		{"isActionHeld", nativeIsActionHeld},
+		{"isActionPressed", nativeIsActionPressed},
+		{"isActionReleased", nativeIsActionReleased},
+		{"getActionValue", nativeGetActionValue},
 		// {"mapInputEventToMouse", nativeMapInputEventToMouse},
 		{NULL, NULL}
 	};
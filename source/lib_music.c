@@ -2,6 +2,7 @@
 
 #include "box_common.h"
 #include "box_engine.h"
+#include "box_pack.h"
 
 #include "drive_system.h"
 
@@ -41,7 +42,7 @@ static int nativeLoadMusic(Toy_Interpreter* interpreter, Toy_LiteralArray* argum
 		Mix_FreeMusic(engine.music);
 	}
 
-	engine.music = Mix_LoadMUS(Toy_toCString( TOY_AS_STRING(pathLiteral) ));
+	engine.music = Mix_LoadMUS_RW(Box_openRWPack(Toy_toCString( TOY_AS_STRING(pathLiteral) )), 1);
 
 	if (engine.music == NULL) {
 		interpreter->errorOutput("Failed to load the music file: ");
@@ -210,6 +211,60 @@ static int nativeSetMusicVolume(Toy_Interpreter* interpreter, Toy_LiteralArray*
 	return 0;
 }
 
+static int nativeLoadMusicAsync(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count != 1 && arguments->count != 2) {
+		interpreter->errorOutput("Incorrect number of arguments passed to loadMusicAsync\n");
+		return -1;
+	}
+
+	//get the filename, and the optional callback
+	Toy_Literal callbackLiteral = arguments->count == 2 ? Toy_popLiteralArray(arguments) : TOY_TO_NULL_LITERAL;
+	Toy_Literal fileLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal callbackLiteralIdn = callbackLiteral;
+	if (TOY_IS_IDENTIFIER(callbackLiteral) && Toy_parseIdentifierToValue(interpreter, &callbackLiteral)) {
+		Toy_freeLiteral(callbackLiteralIdn);
+	}
+
+	Toy_Literal fileLiteralIdn = fileLiteral;
+	if (TOY_IS_IDENTIFIER(fileLiteral) && Toy_parseIdentifierToValue(interpreter, &fileLiteral)) {
+		Toy_freeLiteral(fileLiteralIdn);
+	}
+
+	if (!TOY_IS_STRING(fileLiteral) || !(TOY_IS_NULL(callbackLiteral) || TOY_IS_FUNCTION(callbackLiteral))) {
+		interpreter->errorOutput("Incorrect argument type passed to loadMusicAsync\n");
+		Toy_freeLiteral(fileLiteral);
+		Toy_freeLiteral(callbackLiteral);
+		return -1;
+	}
+
+	//get the path
+	Toy_Literal pathLiteral = Toy_getDrivePathLiteral(interpreter, &fileLiteral);
+
+	if (TOY_IS_NULL(pathLiteral)) {
+		Toy_freeLiteral(fileLiteral);
+		Toy_freeLiteral(callbackLiteral);
+		Toy_freeLiteral(pathLiteral);
+		return -1;
+	}
+
+	//decoded by a worker, then replaces the current music
+	Box_Asset* asset = Box_requestAssetLoader(&engine.assetLoader, BOX_ASSET_MUSIC, pathLiteral, callbackLiteral);
+
+	//return the handle
+	Toy_Literal assetLiteral = TOY_TO_OPAQUE_LITERAL(asset, BOX_OPAQUE_TAG_ASSET);
+
+	Toy_pushLiteralArray(&interpreter->stack, assetLiteral);
+
+	Toy_freeLiteral(fileLiteral);
+	Toy_freeLiteral(callbackLiteral);
+	Toy_freeLiteral(pathLiteral);
+	Toy_freeLiteral(assetLiteral);
+
+	return 1;
+}
+
 //call the hook
 typedef struct Natives {
 	char* name;
@@ -220,6 +275,7 @@ int Box_hookMusic(Toy_Interpreter* interpreter, Toy_Literal identifier, Toy_Lite
 	//build the natives list
 	Natives natives[] = {
 		{"loadMusic", nativeLoadMusic},
+		{"loadMusicAsync", nativeLoadMusicAsync},
 		{"freeMusic", nativefreeMusic},
 		{"playMusic", nativePlayMusic},
 		{"stopMusic", nativeStopMusic},
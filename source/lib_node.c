@@ -10,6 +10,7 @@
 #include "toy_memory.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 static int nativeLoadNode(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
 	if (arguments->count != 1) {
@@ -42,13 +43,18 @@ static int nativeLoadNode(Toy_Interpreter* interpreter, Toy_LiteralArray* argume
 
 	Toy_freeLiteral(drivePathLiteral); //not needed anymore
 
-	//load the new node
+	//load the new node (or fetch it from the cache)
 	size_t size = 0;
-	const unsigned char* source = Toy_readFile(Toy_toCString(TOY_AS_STRING(filePathLiteral)), &size);
-	const unsigned char* tb = Toy_compileString((const char*)source, &size);
-	free((void*)source);
+	Box_BytecodeCacheEntry* entry = NULL;
+	const unsigned char* tb = Box_loadBytecodeCache(&engine.bytecodeCache, filePathLiteral, &size, &entry);
 
-	Box_Node* node = TOY_ALLOCATE(Box_Node, 1);
+	if (tb == NULL) {
+		interpreter->errorOutput("Failed to load the node script in loadNode\n");
+		Toy_freeLiteral(filePathLiteral);
+		return -1;
+	}
+
+	Box_Node* node = Box_allocateNode();
 
 	//BUGFIX: make an -interpreter
 	Toy_Interpreter inner;
@@ -68,18 +74,17 @@ static int nativeLoadNode(Toy_Interpreter* interpreter, Toy_LiteralArray* argume
 	Toy_setInterpreterAssert(&inner, interpreter->assertOutput);
 	Toy_setInterpreterError(&inner, interpreter->errorOutput);
 
-	Box_initNode(node, &inner, tb, size);
+	Box_initSharedNode(node, &inner, tb, size, &entry->functions);
+	Box_trackNodeBytecodeCache(entry, node);
 
 	//immediately call onLoad() after running the script - for loading other nodes
-	Box_callNode(node, &inner, "onLoad", NULL);
+	Box_callNodeHook(node, &inner, BOX_HOOK_ON_LOAD, NULL);
 
 	// return the node
 	Toy_Literal nodeLiteral = TOY_TO_OPAQUE_LITERAL(node, BOX_OPAQUE_TAG_NODE);
 	Toy_pushLiteralArray(&interpreter->stack, nodeLiteral);
 
 	//cleanup (NOT the scope - that needs to hang around)
-	node->scope = inner.scope;
-
 	Toy_freeLiteralArray(&inner.stack);
 	Toy_freeLiteralArray(&inner.literalCache);
 	Toy_freeLiteral(filePathLiteral);
@@ -94,7 +99,7 @@ static int nativeLoadEmptyNode(Toy_Interpreter* interpreter, Toy_LiteralArray* a
 		return -1;
 	}
 
-	Box_Node* node = TOY_ALLOCATE(Box_Node, 1);
+	Box_Node* node = Box_allocateNode();
 	Box_initNode(node, NULL, NULL, 0);
 
 	// return the empty node
@@ -129,7 +134,7 @@ static int nativeInitNode(Toy_Interpreter* interpreter, Toy_LiteralArray* argume
 	Box_Node* node = TOY_AS_OPAQUE(nodeLiteral);
 
 	//init the new node (and ONLY this node)
-	Box_callNode(node, &engine.interpreter, "onInit", NULL);
+	Box_callNodeHook(node, &engine.interpreter, BOX_HOOK_ON_INIT, NULL);
 
 	//cleanup
 	Toy_freeLiteral(nodeLiteral);
@@ -199,7 +204,7 @@ static int nativeFreeNode(Toy_Interpreter* interpreter, Toy_LiteralArray* argume
 	Box_Node* node = TOY_AS_OPAQUE(nodeLiteral);
 
 	//TODO: differentiate between onFree() and freeing memory
-	Box_callRecursiveNode(node, interpreter, "onFree", NULL);
+	Box_callRecursiveNodeHook(node, interpreter, BOX_HOOK_ON_FREE, NULL);
 	Box_freeNode(node);
 
 	//cleanup
@@ -248,13 +253,19 @@ static int nativeLoadChildNode(Toy_Interpreter* interpreter, Toy_LiteralArray* a
 
 	Toy_freeLiteral(drivePathLiteral); //not needed anymore
 
-	//load the new node
+	//load the new node (or fetch it from the cache)
 	size_t size = 0;
-	const unsigned char* source = Toy_readFile(Toy_toCString(TOY_AS_STRING(filePathLiteral)), &size);
-	const unsigned char* tb = Toy_compileString((const char*)source, &size);
-	free((void*)source);
+	Box_BytecodeCacheEntry* entry = NULL;
+	const unsigned char* tb = Box_loadBytecodeCache(&engine.bytecodeCache, filePathLiteral, &size, &entry);
+
+	if (tb == NULL) {
+		interpreter->errorOutput("Failed to load the node script in loadChildNode\n");
+		Toy_freeLiteral(parentLiteral);
+		Toy_freeLiteral(filePathLiteral);
+		return -1;
+	}
 
-	Box_Node* node = TOY_ALLOCATE(Box_Node, 1);
+	Box_Node* node = Box_allocateNode();
 
 	//BUGFIX: make an inner-interpreter
 	Toy_Interpreter inner;
@@ -274,10 +285,11 @@ static int nativeLoadChildNode(Toy_Interpreter* interpreter, Toy_LiteralArray* a
 	Toy_setInterpreterAssert(&inner, interpreter->assertOutput);
 	Toy_setInterpreterError(&inner, interpreter->errorOutput);
 
-	Box_initNode(node, &inner, tb, size);
+	Box_initSharedNode(node, &inner, tb, size, &entry->functions);
+	Box_trackNodeBytecodeCache(entry, node);
 
 	//immediately call onLoad() after running the script - for loading other nodes
-	Box_callNode(node, &inner, "onLoad", NULL);
+	Box_callNodeHook(node, &inner, BOX_HOOK_ON_LOAD, NULL);
 
 	//push the new node onto the parent node's child list
 	Box_Node* parent = (Box_Node*)TOY_AS_OPAQUE(parentLiteral);
@@ -288,8 +300,6 @@ static int nativeLoadChildNode(Toy_Interpreter* interpreter, Toy_LiteralArray* a
 	Toy_pushLiteralArray(&interpreter->stack, nodeLiteral);
 
 	//cleanup (NOT the scope - that needs to hang around)
-	node->scope = inner.scope;
-
 	Toy_freeLiteralArray(&inner.stack);
 	Toy_freeLiteralArray(&inner.literalCache);
 	Toy_freeLiteral(filePathLiteral);
@@ -320,7 +330,7 @@ static int nativeLoadEmptyChildNode(Toy_Interpreter* interpreter, Toy_LiteralArr
 		return -1;
 	}
 
-	Box_Node* node = TOY_ALLOCATE(Box_Node, 1);
+	Box_Node* node = Box_allocateNode();
 	Box_initNode(node, NULL, NULL, 0);
 
 	//push the new node onto the parent node's child list
@@ -433,7 +443,7 @@ static int nativeFreeChildNode(Toy_Interpreter* interpreter, Toy_LiteralArray* a
 	}
 
 	//TODO: differentiate between onFree() and freeing memory
-	Box_callRecursiveNode(node->children[idx], interpreter, "onFree", NULL);
+	Box_callRecursiveNodeHook(node->children[idx], interpreter, BOX_HOOK_ON_FREE, NULL);
 	Box_freeChildNode(node, idx);
 
 	//cleanup
@@ -1801,6 +1811,80 @@ static int nativeGetNodeLayer(Toy_Interpreter* interpreter, Toy_LiteralArray* ar
 	return 1;
 }
 
+static int nativeSetNodeAutoDraw(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 2) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setNodeAutoDraw\n");
+		return -1;
+	}
+
+	//extract the arguments
+	Toy_Literal autoDrawLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal nodeLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal nodeIdn = nodeLiteral;
+	if (TOY_IS_IDENTIFIER(nodeLiteral) && Toy_parseIdentifierToValue(interpreter, &nodeLiteral)) {
+		Toy_freeLiteral(nodeIdn);
+	}
+
+	Toy_Literal autoDrawLiteralIdn = autoDrawLiteral;
+	if (TOY_IS_IDENTIFIER(autoDrawLiteral) && Toy_parseIdentifierToValue(interpreter, &autoDrawLiteral)) {
+		Toy_freeLiteral(autoDrawLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_OPAQUE(nodeLiteral) || !TOY_IS_BOOLEAN(autoDrawLiteral) || TOY_GET_OPAQUE_TAG(nodeLiteral) != BOX_OPAQUE_TAG_NODE) {
+		interpreter->errorOutput("Incorrect argument type passed to setNodeAutoDraw\n");
+		Toy_freeLiteral(nodeLiteral);
+		Toy_freeLiteral(autoDrawLiteral);
+		return -1;
+	}
+
+	//actually set
+	Box_Node* node = (Box_Node*)TOY_AS_OPAQUE(nodeLiteral);
+
+	Box_setAutoDrawNode(node, TOY_AS_BOOLEAN(autoDrawLiteral));
+
+	//cleanup
+	Toy_freeLiteral(nodeLiteral);
+	Toy_freeLiteral(autoDrawLiteral);
+
+	return 0;
+}
+
+static int nativeGetNodeAutoDraw(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getNodeAutoDraw\n");
+		return -1;
+	}
+
+	//extract the arguments
+	Toy_Literal nodeLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal nodeIdn = nodeLiteral;
+	if (TOY_IS_IDENTIFIER(nodeLiteral) && Toy_parseIdentifierToValue(interpreter, &nodeLiteral)) {
+		Toy_freeLiteral(nodeIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_OPAQUE(nodeLiteral) || TOY_GET_OPAQUE_TAG(nodeLiteral) != BOX_OPAQUE_TAG_NODE) {
+		interpreter->errorOutput("Incorrect argument type passed to getNodeAutoDraw\n");
+		Toy_freeLiteral(nodeLiteral);
+		return -1;
+	}
+
+	//actually get
+	Box_Node* node = (Box_Node*)TOY_AS_OPAQUE(nodeLiteral);
+	Toy_Literal autoDrawLiteral = TOY_TO_BOOLEAN_LITERAL(Box_getAutoDrawNode(node));
+
+	Toy_pushLiteralArray(&interpreter->stack, autoDrawLiteral);
+
+	//cleanup
+	Toy_freeLiteral(nodeLiteral);
+	Toy_freeLiteral(autoDrawLiteral);
+
+	return 1;
+}
+
 static int nativeDrawNode(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
 	if (arguments->count != 3 && arguments->count != 5) {
 		interpreter->errorOutput("Incorrect number of arguments passed to drawNode\n");
@@ -1968,10 +2052,10 @@ static int nativeSetNodeText(Toy_Interpreter* interpreter, Toy_LiteralArray* arg
 		return -1;
 	}
 
-	//get the font
+	//get the font (or fetch it from the cache)
 	Toy_Literal fileLiteral = Toy_getDrivePathLiteral(interpreter, &fontLiteral);
 
-	TTF_Font* font = TTF_OpenFont( Toy_toCString(TOY_AS_STRING(fileLiteral)), TOY_AS_INTEGER(sizeLiteral) );
+	TTF_Font* font = Box_loadFontCache(&engine.fontCache, fileLiteral, TOY_AS_INTEGER(sizeLiteral));
 
 	if (!font) {
 		interpreter->errorOutput("Failed to open a font file: ");
@@ -1998,8 +2082,156 @@ static int nativeSetNodeText(Toy_Interpreter* interpreter, Toy_LiteralArray* arg
 	Box_setTextNode(node, font, Toy_toCString(TOY_AS_STRING(textLiteral)), color);
 
 	//cleanup
-	TTF_CloseFont(font);
+	Toy_freeLiteral(fileLiteral);
+	Toy_freeLiteral(nodeLiteral);
+	Toy_freeLiteral(fontLiteral);
+	Toy_freeLiteral(sizeLiteral);
+	Toy_freeLiteral(textLiteral);
+	Toy_freeLiteral(rLiteral);
+	Toy_freeLiteral(gLiteral);
+	Toy_freeLiteral(bLiteral);
+	Toy_freeLiteral(aLiteral);
+
+	return 0;
+}
+
+static int nativeSetNodeGlyphText(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 8) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setNodeGlyphText\n");
+		return -1;
+	}
+
+	//extract the arguments
+	Toy_Literal aLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal bLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal gLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal rLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal textLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal sizeLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal fontLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal nodeLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal nodeLiteralIdn = nodeLiteral;
+	if (TOY_IS_IDENTIFIER(nodeLiteral) && Toy_parseIdentifierToValue(interpreter, &nodeLiteral)) {
+		Toy_freeLiteral(nodeLiteralIdn);
+	}
+
+	Toy_Literal fontLiteralIdn = fontLiteral;
+	if (TOY_IS_IDENTIFIER(fontLiteral) && Toy_parseIdentifierToValue(interpreter, &fontLiteral)) {
+		Toy_freeLiteral(fontLiteralIdn);
+	}
+
+	Toy_Literal sizeLiteralIdn = sizeLiteral;
+	if (TOY_IS_IDENTIFIER(sizeLiteral) && Toy_parseIdentifierToValue(interpreter, &sizeLiteral)) {
+		Toy_freeLiteral(sizeLiteralIdn);
+	}
+
+	Toy_Literal textLiteralIdn = textLiteral;
+	if (TOY_IS_IDENTIFIER(textLiteral) && Toy_parseIdentifierToValue(interpreter, &textLiteral)) {
+		Toy_freeLiteral(textLiteralIdn);
+	}
+
+	Toy_Literal rLiteralIdn = rLiteral;
+	if (TOY_IS_IDENTIFIER(rLiteral) && Toy_parseIdentifierToValue(interpreter, &rLiteral)) {
+		Toy_freeLiteral(rLiteralIdn);
+	}
+
+	Toy_Literal gLiteralIdn = gLiteral;
+	if (TOY_IS_IDENTIFIER(gLiteral) && Toy_parseIdentifierToValue(interpreter, &gLiteral)) {
+		Toy_freeLiteral(gLiteralIdn);
+	}
+
+	Toy_Literal bLiteralIdn = bLiteral;
+	if (TOY_IS_IDENTIFIER(bLiteral) && Toy_parseIdentifierToValue(interpreter, &bLiteral)) {
+		Toy_freeLiteral(bLiteralIdn);
+	}
+
+	Toy_Literal aLiteralIdn = aLiteral;
+	if (TOY_IS_IDENTIFIER(aLiteral) && Toy_parseIdentifierToValue(interpreter, &aLiteral)) {
+		Toy_freeLiteral(aLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_OPAQUE(nodeLiteral) || !TOY_IS_STRING(fontLiteral)  || !TOY_IS_INTEGER(sizeLiteral) || !TOY_IS_STRING(textLiteral)
+		|| !TOY_IS_INTEGER(rLiteral) || !TOY_IS_INTEGER(gLiteral) || !TOY_IS_INTEGER(bLiteral) || !TOY_IS_INTEGER(aLiteral)
+		|| TOY_GET_OPAQUE_TAG(nodeLiteral) != BOX_OPAQUE_TAG_NODE) {
+		interpreter->errorOutput("Incorrect argument type passed to setNodeGlyphText\n");
+		Toy_freeLiteral(nodeLiteral);
+		Toy_freeLiteral(fontLiteral);
+		Toy_freeLiteral(sizeLiteral);
+		Toy_freeLiteral(textLiteral);
+		Toy_freeLiteral(rLiteral);
+		Toy_freeLiteral(gLiteral);
+		Toy_freeLiteral(bLiteral);
+		Toy_freeLiteral(aLiteral);
+		return -1;
+	}
+
+	//bounds checks
+	if (TOY_AS_INTEGER(rLiteral) < 0 || TOY_AS_INTEGER(rLiteral) > 255 ||
+		TOY_AS_INTEGER(gLiteral) < 0 || TOY_AS_INTEGER(gLiteral) > 255 ||
+		TOY_AS_INTEGER(bLiteral) < 0 || TOY_AS_INTEGER(bLiteral) > 255 ||
+		TOY_AS_INTEGER(aLiteral) < 0 || TOY_AS_INTEGER(aLiteral) > 255) {
+		interpreter->errorOutput("Color out of bounds in to setNodeGlyphText\n");
+		Toy_freeLiteral(nodeLiteral);
+		Toy_freeLiteral(fontLiteral);
+		Toy_freeLiteral(sizeLiteral);
+		Toy_freeLiteral(textLiteral);
+		Toy_freeLiteral(rLiteral);
+		Toy_freeLiteral(gLiteral);
+		Toy_freeLiteral(bLiteral);
+		Toy_freeLiteral(aLiteral);
+		return -1;
+	}
+
+	//get the font (or fetch it from the cache)
+	Toy_Literal fileLiteral = Toy_getDrivePathLiteral(interpreter, &fontLiteral);
+
+	TTF_Font* font = Box_loadFontCache(&engine.fontCache, fileLiteral, TOY_AS_INTEGER(sizeLiteral));
+
+	if (!font) {
+		interpreter->errorOutput("Failed to open a font file: ");
+		interpreter->errorOutput(SDL_GetError());
+		interpreter->errorOutput("\n");
+
+		Toy_freeLiteral(fileLiteral);
+		Toy_freeLiteral(nodeLiteral);
+		Toy_freeLiteral(fontLiteral);
+		Toy_freeLiteral(sizeLiteral);
+		Toy_freeLiteral(textLiteral);
+		Toy_freeLiteral(rLiteral);
+		Toy_freeLiteral(gLiteral);
+		Toy_freeLiteral(bLiteral);
+		Toy_freeLiteral(aLiteral);
+		return -1;
+	}
+
+	//rasterized once per font, on first use
+	Box_GlyphAtlas* atlas = Box_loadGlyphCache(&engine.glyphCache, engine.renderer, font);
+
+	if (!atlas) {
+		interpreter->errorOutput("Failed to build a glyph atlas in setNodeGlyphText\n");
+
+		Toy_freeLiteral(fileLiteral);
+		Toy_freeLiteral(nodeLiteral);
+		Toy_freeLiteral(fontLiteral);
+		Toy_freeLiteral(sizeLiteral);
+		Toy_freeLiteral(textLiteral);
+		Toy_freeLiteral(rLiteral);
+		Toy_freeLiteral(gLiteral);
+		Toy_freeLiteral(bLiteral);
+		Toy_freeLiteral(aLiteral);
+		return -1;
+	}
 
+	//make the color
+	SDL_Color color = (SDL_Color){ .r = TOY_AS_INTEGER(rLiteral), .g = TOY_AS_INTEGER(gLiteral), .b = TOY_AS_INTEGER(bLiteral), .a = TOY_AS_INTEGER(aLiteral) };
+
+	//actually set
+	Box_Node* node = (Box_Node*)TOY_AS_OPAQUE(nodeLiteral);
+	Box_setGlyphTextNode(node, atlas, Toy_toCString(TOY_AS_STRING(textLiteral)), color);
+
+	//cleanup
 	Toy_freeLiteral(fileLiteral);
 	Toy_freeLiteral(nodeLiteral);
 	Toy_freeLiteral(fontLiteral);
@@ -2013,6 +2245,35 @@ static int nativeSetNodeText(Toy_Interpreter* interpreter, Toy_LiteralArray* arg
 	return 0;
 }
 
+static int nativeReserveNodes(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to reserveNodes\n");
+		return -1;
+	}
+
+	Toy_Literal countLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal countLiteralIdn = countLiteral;
+	if (TOY_IS_IDENTIFIER(countLiteral) && Toy_parseIdentifierToValue(interpreter, &countLiteral)) {
+		Toy_freeLiteral(countLiteralIdn);
+	}
+
+	//check argument types
+	if (!TOY_IS_INTEGER(countLiteral) || TOY_AS_INTEGER(countLiteral) < 0) {
+		interpreter->errorOutput("Incorrect argument type passed to reserveNodes\n");
+		Toy_freeLiteral(countLiteral);
+		return -1;
+	}
+
+	//pre-allocate the nodes, so spawning them later doesn't allocate
+	Box_reserveNodePool(&engine.nodePool, TOY_AS_INTEGER(countLiteral));
+
+	//cleanup
+	Toy_freeLiteral(countLiteral);
+
+	return 0;
+}
+
 static int nativeCallNodeFn(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
 	//checks
 	if (arguments->count < 2) {
@@ -2088,6 +2349,305 @@ static int nativeCallNodeFn(Toy_Interpreter* interpreter, Toy_LiteralArray* argu
 	return 1;
 }
 
+static int nativeSetNodeFn(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	if (arguments->count != 3) {
+		interpreter->errorOutput("Incorrect number of arguments passed to setNodeFn\n");
+		return -1;
+	}
+
+	//extract the arguments
+	Toy_Literal fnLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal fnName = Toy_popLiteralArray(arguments);
+	Toy_Literal nodeLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal nodeIdn = nodeLiteral;
+	if (TOY_IS_IDENTIFIER(nodeLiteral) && Toy_parseIdentifierToValue(interpreter, &nodeLiteral)) {
+		Toy_freeLiteral(nodeIdn);
+	}
+
+	Toy_Literal fnNameIdn = fnName;
+	if (TOY_IS_IDENTIFIER(fnName) && Toy_parseIdentifierToValue(interpreter, &fnName)) {
+		Toy_freeLiteral(fnNameIdn);
+	}
+
+	Toy_Literal fnLiteralIdn = fnLiteral;
+	if (TOY_IS_IDENTIFIER(fnLiteral) && Toy_parseIdentifierToValue(interpreter, &fnLiteral)) {
+		Toy_freeLiteral(fnLiteralIdn);
+	}
+
+	//check the types
+	if (!TOY_IS_OPAQUE(nodeLiteral) || !TOY_IS_STRING(fnName) || !TOY_IS_FUNCTION(fnLiteral) || TOY_GET_OPAQUE_TAG(nodeLiteral) != BOX_OPAQUE_TAG_NODE) {
+		interpreter->errorOutput("Incorrect argument type passed to setNodeFn\n");
+		Toy_freeLiteral(nodeLiteral);
+		Toy_freeLiteral(fnName);
+		Toy_freeLiteral(fnLiteral);
+		return -1;
+	}
+
+	//allow refstring to do it's magic
+	Toy_Literal fnNameIdentifier = TOY_TO_IDENTIFIER_LITERAL(Toy_copyRefString(TOY_AS_STRING(fnName)));
+
+	//only this node is affected, as a shared table is copied first
+	Box_setFunctionNode(TOY_AS_OPAQUE(nodeLiteral), fnNameIdentifier, fnLiteral);
+
+	//cleanup
+	Toy_freeLiteral(fnNameIdentifier);
+	Toy_freeLiteral(nodeLiteral);
+	Toy_freeLiteral(fnName);
+	Toy_freeLiteral(fnLiteral);
+
+	return 0;
+}
+
+//is this event one of the lifecycle hooks?
+static int findHookUtil(Toy_Literal eventLiteral) {
+	for (int i = 0; i < BOX_HOOK_COUNT; i++) {
+		if (!strcmp(Toy_toCString(TOY_AS_STRING(eventLiteral)), Box_getHookName(i))) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static int nativeSubscribeNodeEvent(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count != 2 && arguments->count != 3) {
+		interpreter->errorOutput("Incorrect number of arguments passed to subscribeNodeEvent\n");
+		return -1;
+	}
+
+	//the function's name defaults to the event's
+	Toy_Literal fnName = arguments->count == 3 ? Toy_popLiteralArray(arguments) : TOY_TO_NULL_LITERAL;
+	Toy_Literal eventLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal nodeLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal nodeIdn = nodeLiteral;
+	if (TOY_IS_IDENTIFIER(nodeLiteral) && Toy_parseIdentifierToValue(interpreter, &nodeLiteral)) {
+		Toy_freeLiteral(nodeIdn);
+	}
+
+	Toy_Literal eventIdn = eventLiteral;
+	if (TOY_IS_IDENTIFIER(eventLiteral) && Toy_parseIdentifierToValue(interpreter, &eventLiteral)) {
+		Toy_freeLiteral(eventIdn);
+	}
+
+	Toy_Literal fnNameIdn = fnName;
+	if (TOY_IS_IDENTIFIER(fnName) && Toy_parseIdentifierToValue(interpreter, &fnName)) {
+		Toy_freeLiteral(fnNameIdn);
+	}
+
+	//check the types
+	if (!TOY_IS_OPAQUE(nodeLiteral) || TOY_GET_OPAQUE_TAG(nodeLiteral) != BOX_OPAQUE_TAG_NODE || !TOY_IS_STRING(eventLiteral) || !(TOY_IS_NULL(fnName) || TOY_IS_STRING(fnName))) {
+		interpreter->errorOutput("Incorrect argument type passed to subscribeNodeEvent\n");
+		Toy_freeLiteral(nodeLiteral);
+		Toy_freeLiteral(eventLiteral);
+		Toy_freeLiteral(fnName);
+		return -1;
+	}
+
+	Box_Node* node = TOY_AS_OPAQUE(nodeLiteral);
+	int hook = findHookUtil(eventLiteral);
+
+	//the lifecycle hooks are subscribed to by defining them, so this only undoes unsubscribeNodeEvent()
+	if (hook >= 0) {
+		if (!TOY_IS_NULL(fnName)) {
+			interpreter->errorOutput("Lifecycle hooks can't be bound to another function in subscribeNodeEvent\n");
+			Toy_freeLiteral(nodeLiteral);
+			Toy_freeLiteral(eventLiteral);
+			Toy_freeLiteral(fnName);
+			return -1;
+		}
+
+		Box_muteHookDispatcher(&engine.dispatcher, node, hook, false);
+	}
+	else {
+		//allow refstring to do it's magic
+		Toy_Literal fnNameIdentifier = TOY_TO_IDENTIFIER_LITERAL(Toy_copyRefString(TOY_AS_STRING(TOY_IS_NULL(fnName) ? eventLiteral : fnName)));
+
+		Box_subscribeDispatcher(&engine.dispatcher, node, eventLiteral, fnNameIdentifier);
+
+		Toy_freeLiteral(fnNameIdentifier);
+	}
+
+	//cleanup
+	Toy_freeLiteral(nodeLiteral);
+	Toy_freeLiteral(eventLiteral);
+	Toy_freeLiteral(fnName);
+
+	return 0;
+}
+
+static int nativeUnsubscribeNodeEvent(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count != 2) {
+		interpreter->errorOutput("Incorrect number of arguments passed to unsubscribeNodeEvent\n");
+		return -1;
+	}
+
+	Toy_Literal eventLiteral = Toy_popLiteralArray(arguments);
+	Toy_Literal nodeLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal nodeIdn = nodeLiteral;
+	if (TOY_IS_IDENTIFIER(nodeLiteral) && Toy_parseIdentifierToValue(interpreter, &nodeLiteral)) {
+		Toy_freeLiteral(nodeIdn);
+	}
+
+	Toy_Literal eventIdn = eventLiteral;
+	if (TOY_IS_IDENTIFIER(eventLiteral) && Toy_parseIdentifierToValue(interpreter, &eventLiteral)) {
+		Toy_freeLiteral(eventIdn);
+	}
+
+	//check the types
+	if (!TOY_IS_OPAQUE(nodeLiteral) || TOY_GET_OPAQUE_TAG(nodeLiteral) != BOX_OPAQUE_TAG_NODE || !TOY_IS_STRING(eventLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to unsubscribeNodeEvent\n");
+		Toy_freeLiteral(nodeLiteral);
+		Toy_freeLiteral(eventLiteral);
+		return -1;
+	}
+
+	Box_Node* node = TOY_AS_OPAQUE(nodeLiteral);
+	int hook = findHookUtil(eventLiteral);
+
+	//the node keeps the function, so it can still be called directly
+	if (hook >= 0) {
+		Box_muteHookDispatcher(&engine.dispatcher, node, hook, true);
+	}
+	else {
+		Box_unsubscribeDispatcher(&engine.dispatcher, node, eventLiteral);
+	}
+
+	//cleanup
+	Toy_freeLiteral(nodeLiteral);
+	Toy_freeLiteral(eventLiteral);
+
+	return 0;
+}
+
+static int nativeEmitNodeEvent(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count < 1) {
+		interpreter->errorOutput("Too few arguments passed to emitNodeEvent\n");
+		return -1;
+	}
+
+	Toy_LiteralArray extraArgsBackwards;
+	Toy_initLiteralArray(&extraArgsBackwards);
+
+	//extract the extra arg values
+	while (arguments->count > 1) {
+		Toy_Literal tmp = Toy_popLiteralArray(arguments);
+
+		Toy_Literal idn = tmp;
+		if (TOY_IS_IDENTIFIER(tmp) && Toy_parseIdentifierToValue(interpreter, &tmp)) {
+			Toy_freeLiteral(idn);
+		}
+
+		Toy_pushLiteralArray(&extraArgsBackwards, tmp);
+		Toy_freeLiteral(tmp);
+	}
+
+	//reverse the extra args
+	Toy_LiteralArray extraArgs;
+	Toy_initLiteralArray(&extraArgs);
+
+	while (extraArgsBackwards.count > 0) {
+		Toy_Literal tmp = Toy_popLiteralArray(&extraArgsBackwards);
+		Toy_pushLiteralArray(&extraArgs, tmp);
+		Toy_freeLiteral(tmp);
+	}
+
+	Toy_freeLiteralArray(&extraArgsBackwards);
+
+	//back on track
+	Toy_Literal eventLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal eventIdn = eventLiteral;
+	if (TOY_IS_IDENTIFIER(eventLiteral) && Toy_parseIdentifierToValue(interpreter, &eventLiteral)) {
+		Toy_freeLiteral(eventIdn);
+	}
+
+	if (!TOY_IS_STRING(eventLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to emitNodeEvent\n");
+		Toy_freeLiteralArray(&extraArgs);
+		Toy_freeLiteral(eventLiteral);
+		return -1;
+	}
+
+	//every subscriber is called, in the order they subscribed
+	int called = Box_emitDispatcher(&engine.dispatcher, interpreter, eventLiteral, &extraArgs);
+
+	Toy_Literal resultLiteral = TOY_TO_INTEGER_LITERAL(called);
+	Toy_pushLiteralArray(&interpreter->stack, resultLiteral);
+
+	//cleanup
+	Toy_freeLiteralArray(&extraArgs);
+	Toy_freeLiteral(eventLiteral);
+	Toy_freeLiteral(resultLiteral);
+
+	return 1;
+}
+
+static int nativePostNodeEvent(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count < 1) {
+		interpreter->errorOutput("Too few arguments passed to postNodeEvent\n");
+		return -1;
+	}
+
+	Toy_LiteralArray extraArgsBackwards;
+	Toy_initLiteralArray(&extraArgsBackwards);
+
+	//extract the extra arg values
+	while (arguments->count > 1) {
+		Toy_Literal tmp = Toy_popLiteralArray(arguments);
+
+		Toy_Literal idn = tmp;
+		if (TOY_IS_IDENTIFIER(tmp) && Toy_parseIdentifierToValue(interpreter, &tmp)) {
+			Toy_freeLiteral(idn);
+		}
+
+		Toy_pushLiteralArray(&extraArgsBackwards, tmp);
+		Toy_freeLiteral(tmp);
+	}
+
+	//reverse the extra args
+	Toy_LiteralArray extraArgs;
+	Toy_initLiteralArray(&extraArgs);
+
+	while (extraArgsBackwards.count > 0) {
+		Toy_Literal tmp = Toy_popLiteralArray(&extraArgsBackwards);
+		Toy_pushLiteralArray(&extraArgs, tmp);
+		Toy_freeLiteral(tmp);
+	}
+
+	Toy_freeLiteralArray(&extraArgsBackwards);
+
+	//back on track
+	Toy_Literal eventLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal eventIdn = eventLiteral;
+	if (TOY_IS_IDENTIFIER(eventLiteral) && Toy_parseIdentifierToValue(interpreter, &eventLiteral)) {
+		Toy_freeLiteral(eventIdn);
+	}
+
+	if (!TOY_IS_STRING(eventLiteral)) {
+		interpreter->errorOutput("Incorrect argument type passed to postNodeEvent\n");
+		Toy_freeLiteralArray(&extraArgs);
+		Toy_freeLiteral(eventLiteral);
+		return -1;
+	}
+
+	//queued until the engine drains the bus, at the start of the next frame
+	Box_postDispatcher(&engine.dispatcher, eventLiteral, &extraArgs);
+
+	//cleanup
+	Toy_freeLiteralArray(&extraArgs);
+	Toy_freeLiteral(eventLiteral);
+
+	return 0;
+}
+
 //call the hook
 typedef struct Natives {
 	char* name;
@@ -2142,9 +2702,18 @@ int Box_hookNode(Toy_Interpreter* interpreter, Toy_Literal identifier, Toy_Liter
 		{"getNodeWorldScaleY", nativeGetNodeWorldScaleY},
 		{"setNodeLayer", nativeSetNodeLayer},
 		{"getNodeLayer", nativeGetNodeLayer},
+		{"setNodeAutoDraw", nativeSetNodeAutoDraw},
+		{"getNodeAutoDraw", nativeGetNodeAutoDraw},
 		{"drawNode", nativeDrawNode},
 		{"setNodeText", nativeSetNodeText},
+		{"setNodeGlyphText", nativeSetNodeGlyphText},
 		{"callNodeFn", nativeCallNodeFn},
+		{"setNodeFn", nativeSetNodeFn},
+		{"subscribeNodeEvent", nativeSubscribeNodeEvent},
+		{"unsubscribeNodeEvent", nativeUnsubscribeNodeEvent},
+		{"emitNodeEvent", nativeEmitNodeEvent},
+		{"postNodeEvent", nativePostNodeEvent},
+		{"reserveNodes", nativeReserveNodes},
 
 		//TODO: get node var?, create empty node, set node color (tinting)
 		{NULL, NULL},
@@ -1,6 +1,8 @@
 #include "lib_sound.h"
 
 #include "box_common.h"
+#include "box_engine.h"
+#include "box_pack.h"
 
 #include "drive_system.h"
 
@@ -37,7 +39,7 @@ static int nativeLoadSound(Toy_Interpreter* interpreter, Toy_LiteralArray* argum
 	}
 
 	//load the file
-	Mix_Chunk* sound = Mix_LoadWAV(Toy_toCString( TOY_AS_STRING(pathLiteral) ));
+	Mix_Chunk* sound = Mix_LoadWAV_RW(Box_openRWPack(Toy_toCString( TOY_AS_STRING(pathLiteral) )), 1);
 
 	if (sound == NULL) {
 		interpreter->errorOutput("Failed to load the sound file: ");
@@ -199,6 +201,101 @@ static int nativeSetSoundVolume(Toy_Interpreter* interpreter, Toy_LiteralArray*
 	return 0;
 }
 
+static int nativeLoadSoundAsync(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count != 1 && arguments->count != 2) {
+		interpreter->errorOutput("Incorrect number of arguments passed to loadSoundAsync\n");
+		return -1;
+	}
+
+	//get the filename, and the optional callback
+	Toy_Literal callbackLiteral = arguments->count == 2 ? Toy_popLiteralArray(arguments) : TOY_TO_NULL_LITERAL;
+	Toy_Literal fileLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal callbackLiteralIdn = callbackLiteral;
+	if (TOY_IS_IDENTIFIER(callbackLiteral) && Toy_parseIdentifierToValue(interpreter, &callbackLiteral)) {
+		Toy_freeLiteral(callbackLiteralIdn);
+	}
+
+	Toy_Literal fileLiteralIdn = fileLiteral;
+	if (TOY_IS_IDENTIFIER(fileLiteral) && Toy_parseIdentifierToValue(interpreter, &fileLiteral)) {
+		Toy_freeLiteral(fileLiteralIdn);
+	}
+
+	if (!TOY_IS_STRING(fileLiteral) || !(TOY_IS_NULL(callbackLiteral) || TOY_IS_FUNCTION(callbackLiteral))) {
+		interpreter->errorOutput("Incorrect argument type passed to loadSoundAsync\n");
+		Toy_freeLiteral(fileLiteral);
+		Toy_freeLiteral(callbackLiteral);
+		return -1;
+	}
+
+	//get the path
+	Toy_Literal pathLiteral = Toy_getDrivePathLiteral(interpreter, &fileLiteral);
+
+	if (TOY_IS_NULL(pathLiteral)) {
+		Toy_freeLiteral(fileLiteral);
+		Toy_freeLiteral(callbackLiteral);
+		Toy_freeLiteral(pathLiteral);
+		return -1;
+	}
+
+	//decoded by a worker, then claimed with getAssetSound()
+	Box_Asset* asset = Box_requestAssetLoader(&engine.assetLoader, BOX_ASSET_SOUND, pathLiteral, callbackLiteral);
+
+	//return the handle
+	Toy_Literal assetLiteral = TOY_TO_OPAQUE_LITERAL(asset, BOX_OPAQUE_TAG_ASSET);
+
+	Toy_pushLiteralArray(&interpreter->stack, assetLiteral);
+
+	Toy_freeLiteral(fileLiteral);
+	Toy_freeLiteral(callbackLiteral);
+	Toy_freeLiteral(pathLiteral);
+	Toy_freeLiteral(assetLiteral);
+
+	return 1;
+}
+
+static int nativeGetAssetSound(Toy_Interpreter* interpreter, Toy_LiteralArray* arguments) {
+	//checks
+	if (arguments->count != 1) {
+		interpreter->errorOutput("Incorrect number of arguments passed to getAssetSound\n");
+		return -1;
+	}
+
+	//get the asset
+	Toy_Literal assetLiteral = Toy_popLiteralArray(arguments);
+
+	Toy_Literal assetLiteralIdn = assetLiteral;
+	if (TOY_IS_IDENTIFIER(assetLiteral) && Toy_parseIdentifierToValue(interpreter, &assetLiteral)) {
+		Toy_freeLiteral(assetLiteralIdn);
+	}
+
+	if (!TOY_IS_OPAQUE(assetLiteral) || TOY_GET_OPAQUE_TAG(assetLiteral) != BOX_OPAQUE_TAG_ASSET) {
+		interpreter->errorOutput("Incorrect argument type passed to getAssetSound\n");
+		Toy_freeLiteral(assetLiteral);
+		return -1;
+	}
+
+	Box_Asset* asset = TOY_AS_OPAQUE(assetLiteral);
+
+	if (asset->kind != BOX_ASSET_SOUND || asset->state != BOX_ASSET_READY || asset->chunk == NULL) {
+		interpreter->errorOutput("The asset passed to getAssetSound isn't a ready, unclaimed sound\n");
+		Toy_freeLiteral(assetLiteral);
+		return -1;
+	}
+
+	//the script owns the sound from now on, and frees it with freeSound()
+	Toy_Literal soundLiteral = TOY_TO_OPAQUE_LITERAL(asset->chunk, TOY_OPAQUE_TAG_SOUND);
+	asset->chunk = NULL;
+
+	Toy_pushLiteralArray(&interpreter->stack, soundLiteral);
+
+	Toy_freeLiteral(soundLiteral);
+	Toy_freeLiteral(assetLiteral);
+
+	return 1;
+}
+
 //call the hook
 typedef struct Natives {
 	char* name;
@@ -209,6 +306,8 @@ int Box_hookSound(Toy_Interpreter* interpreter, Toy_Literal identifier, Toy_Lite
 	//build the natives list
 	Natives natives[] = {
 		{"loadSound", nativeLoadSound},
+		{"loadSoundAsync", nativeLoadSoundAsync},
+		{"getAssetSound", nativeGetAssetSound},
 		{"freeSound", nativeFreeSound},
 		{"playSound", nativePlaySound},
 
@@ -0,0 +1,310 @@
+//builds a pack file for box_pack.c from the folders given to Toy_setDrivePath()
+//usage: pack_builder [-c] output.pack folder [folder ...]
+//	-c: compress the files that shrink enough
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+//must match box_pack.h
+#define PACK_MAGIC "BOXPACK1"
+#define PACK_HEADER_SIZE 16
+#define PACK_RECORD_SIZE 40
+#define PACK_FLAG_COMPRESSED 1
+
+#define HASH_BITS 15
+#define MAX_OFFSET 65535
+#define MIN_MATCH 4
+#define MAX_MATCH (0x7F + MIN_MATCH)
+#define MAX_LITERALS 128
+
+typedef struct Entry {
+	char* name;
+	unsigned char* data; //what gets written
+	size_t storedSize;
+	size_t size;
+	uint32_t flags;
+	uint64_t nameOffset;
+	uint64_t dataOffset;
+} Entry;
+
+static Entry* entries = NULL;
+static size_t entryCount = 0;
+static size_t entryCapacity = 0;
+
+//utils
+static void error(const char* message, const char* detail) {
+	fprintf(stderr, "pack_builder: %s \"%s\"\n", message, detail);
+	exit(-1);
+}
+
+static unsigned char* readFile(const char* path, size_t* size) {
+	FILE* file = fopen(path, "rb");
+
+	if (file == NULL) {
+		error("Could not open", path);
+	}
+
+	fseek(file, 0L, SEEK_END);
+	*size = ftell(file);
+	rewind(file);
+
+	unsigned char* buffer = malloc(*size + 1);
+
+	if (buffer == NULL || fread(buffer, 1, *size, file) != *size) {
+		error("Could not read", path);
+	}
+
+	fclose(file);
+	return buffer;
+}
+
+static void pushEntry(const char* path) {
+	if (entryCount + 1 > entryCapacity) {
+		entryCapacity = entryCapacity < 8 ? 8 : entryCapacity * 2;
+		entries = realloc(entries, entryCapacity * sizeof(Entry));
+	}
+
+	Entry* entry = &entries[entryCount++];
+
+	entry->name = malloc(strlen(path) + 1);
+	strcpy(entry->name, path);
+	entry->data = readFile(path, &entry->size);
+	entry->storedSize = entry->size;
+	entry->flags = 0;
+}
+
+static void scanFolder(const char* folder) {
+	DIR* dir = opendir(folder);
+
+	if (dir == NULL) {
+		error("Could not open folder", folder);
+	}
+
+	struct dirent* ent;
+	while ((ent = readdir(dir)) != NULL) {
+		if (ent->d_name[0] == '.') {
+			continue; //also skips hidden files
+		}
+
+		//the same separator the drive system uses
+		size_t length = strlen(folder) + strlen(ent->d_name) + 2;
+		char* path = malloc(length);
+		snprintf(path, length, "%s/%s", folder, ent->d_name);
+
+		struct stat pathStat;
+		if (stat(path, &pathStat) == 0) {
+			if (S_ISDIR(pathStat.st_mode)) {
+				scanFolder(path);
+			}
+			else if (S_ISREG(pathStat.st_mode)) {
+				pushEntry(path);
+			}
+		}
+
+		free(path);
+	}
+
+	closedir(dir);
+}
+
+static int compareEntries(const void* lhs, const void* rhs) {
+	return strcmp(((const Entry*)lhs)->name, ((const Entry*)rhs)->name);
+}
+
+static size_t flushLiterals(const unsigned char* src, size_t start, size_t end, unsigned char* dest, size_t out, size_t capacity) {
+	while (start < end) {
+		size_t length = end - start < MAX_LITERALS ? end - start : MAX_LITERALS;
+
+		if (out + 1 + length > capacity) {
+			return SIZE_MAX;
+		}
+
+		dest[out++] = (unsigned char)(length - 1);
+		memcpy(dest + out, src + start, length);
+		out += length;
+		start += length;
+	}
+
+	return out;
+}
+
+//greedy LZ, decoded by Box_decompressPack() - returns 0 if the result isn't smaller than "capacity"
+static size_t compress(const unsigned char* src, size_t size, unsigned char* dest, size_t capacity) {
+	static long table[1 << HASH_BITS];
+	for (size_t i = 0; i < (1 << HASH_BITS); i++) {
+		table[i] = -1;
+	}
+
+	size_t out = 0;
+	size_t literalStart = 0;
+	size_t i = 0;
+
+	while (i + MIN_MATCH <= size) {
+		uint32_t sequence = (uint32_t)src[i] | ((uint32_t)src[i + 1] << 8) | ((uint32_t)src[i + 2] << 16) | ((uint32_t)src[i + 3] << 24);
+		uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+		long candidate = table[hash];
+		table[hash] = (long)i;
+
+		if (candidate < 0 || i - candidate > MAX_OFFSET || memcmp(src + candidate, src + i, MIN_MATCH) != 0) {
+			i++;
+			continue;
+		}
+
+		size_t length = MIN_MATCH;
+		while (i + length < size && length < MAX_MATCH && src[candidate + length] == src[i + length]) {
+			length++;
+		}
+
+		out = flushLiterals(src, literalStart, i, dest, out, capacity);
+
+		if (out == SIZE_MAX || out + 3 > capacity) {
+			return 0;
+		}
+
+		size_t offset = i - candidate;
+		dest[out++] = (unsigned char)(0x80 | (length - MIN_MATCH));
+		dest[out++] = (unsigned char)(offset & 0xFF);
+		dest[out++] = (unsigned char)(offset >> 8);
+
+		i += length;
+		literalStart = i;
+	}
+
+	out = flushLiterals(src, literalStart, size, dest, out, capacity);
+
+	return out == SIZE_MAX ? 0 : out;
+}
+
+static void writeU32(unsigned char* p, uint32_t value) {
+	for (int i = 0; i < 4; i++) {
+		p[i] = (unsigned char)(value >> (i * 8));
+	}
+}
+
+static void writeU64(unsigned char* p, uint64_t value) {
+	writeU32(p, (uint32_t)value);
+	writeU32(p + 4, (uint32_t)(value >> 32));
+}
+
+int main(int argc, char* argv[]) {
+	bool compressing = false;
+	int arg = 1;
+
+	if (arg < argc && strcmp(argv[arg], "-c") == 0) {
+		compressing = true;
+		arg++;
+	}
+
+	if (argc - arg < 2) {
+		fprintf(stderr, "usage: pack_builder [-c] output.pack folder [folder ...]\n");
+		return -1;
+	}
+
+	const char* outputPath = argv[arg++];
+
+	for (; arg < argc; arg++) {
+		//strip trailing separators, so the names match the resolved drive paths
+		size_t length = strlen(argv[arg]);
+		while (length > 1 && (argv[arg][length - 1] == '/' || argv[arg][length - 1] == '\\')) {
+			argv[arg][--length] = '\0';
+		}
+
+		scanFolder(argv[arg]);
+	}
+
+	//sorted, for the binary search
+	qsort(entries, entryCount, sizeof(Entry), compareEntries);
+
+	for (size_t i = 1; i < entryCount; i++) {
+		if (strcmp(entries[i - 1].name, entries[i].name) == 0) {
+			error("Duplicate file", entries[i].name);
+		}
+	}
+
+	//only keep the compressed data when it saves at least an eighth
+	size_t savedBytes = 0;
+
+	for (size_t i = 0; compressing && i < entryCount; i++) {
+		Entry* entry = &entries[i];
+		size_t capacity = entry->size - entry->size / 8;
+		unsigned char* buffer = malloc(capacity + 1);
+		size_t compressedSize = capacity > 0 ? compress(entry->data, entry->size, buffer, capacity) : 0;
+
+		if (compressedSize == 0) {
+			free(buffer);
+			continue;
+		}
+
+		savedBytes += entry->size - compressedSize;
+
+		free(entry->data);
+		entry->data = buffer;
+		entry->storedSize = compressedSize;
+		entry->flags |= PACK_FLAG_COMPRESSED;
+	}
+
+	//lay out the names, then the data
+	uint64_t offset = PACK_HEADER_SIZE + (uint64_t)entryCount * PACK_RECORD_SIZE;
+
+	for (size_t i = 0; i < entryCount; i++) {
+		entries[i].nameOffset = offset;
+		offset += strlen(entries[i].name);
+	}
+
+	for (size_t i = 0; i < entryCount; i++) {
+		entries[i].dataOffset = offset;
+		offset += entries[i].storedSize;
+	}
+
+	FILE* file = fopen(outputPath, "wb");
+
+	if (file == NULL) {
+		error("Could not write", outputPath);
+	}
+
+	unsigned char header[PACK_HEADER_SIZE] = {0};
+	memcpy(header, PACK_MAGIC, 8);
+	writeU32(header + 8, (uint32_t)entryCount);
+	fwrite(header, 1, PACK_HEADER_SIZE, file);
+
+	for (size_t i = 0; i < entryCount; i++) {
+		unsigned char record[PACK_RECORD_SIZE] = {0};
+
+		writeU32(record, (uint32_t)entries[i].nameOffset);
+		writeU32(record + 4, (uint32_t)strlen(entries[i].name));
+		writeU32(record + 8, entries[i].flags);
+		writeU64(record + 16, entries[i].dataOffset);
+		writeU64(record + 24, entries[i].storedSize);
+		writeU64(record + 32, entries[i].size);
+
+		fwrite(record, 1, PACK_RECORD_SIZE, file);
+	}
+
+	for (size_t i = 0; i < entryCount; i++) {
+		fwrite(entries[i].name, 1, strlen(entries[i].name), file);
+	}
+
+	for (size_t i = 0; i < entryCount; i++) {
+		fwrite(entries[i].data, 1, entries[i].storedSize, file);
+	}
+
+	fclose(file);
+
+	printf("%s: %zu files, %llu bytes (%zu saved by compression)\n", outputPath, entryCount, (unsigned long long)offset, savedBytes);
+
+	for (size_t i = 0; i < entryCount; i++) {
+		free(entries[i].name);
+		free(entries[i].data);
+	}
+
+	free(entries);
+
+	return 0;
+}
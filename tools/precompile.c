@@ -0,0 +1,114 @@
+//mirrors a drive folder with every .toy script precompiled, for builds using BOX_NO_COMPILER
+//usage: precompile source_folder dest_folder
+//	the scripts keep their names, so nothing that loads them needs to change, and other files are copied as-is
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "repl_tools.h"
+
+#include "toy_memory.h"
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+static int compiled = 0;
+static int copied = 0;
+static int failed = 0;
+
+//utils
+static char* joinPath(const char* folder, const char* name) {
+	size_t length = strlen(folder) + strlen(name) + 2;
+	char* path = malloc(length);
+	snprintf(path, length, "%s/%s", folder, name);
+	return path;
+}
+
+static bool isScript(const char* name) {
+	size_t length = strlen(name);
+	return length > 4 && strcmp(name + length - 4, ".toy") == 0;
+}
+
+static void processFile(const char* sourcePath, const char* destPath, bool script) {
+	size_t size = 0;
+	const unsigned char* data = Toy_readFile(sourcePath, &size);
+
+	if (data == NULL) {
+		failed++;
+		return;
+	}
+
+	if (!script) {
+		failed += Toy_writeFile(destPath, data, size) != 0;
+		copied++;
+		free((void*)data);
+		return;
+	}
+
+	const unsigned char* tb = Toy_compileString((const char*)data, &size);
+	free((void*)data);
+
+	if (tb == NULL) {
+		fprintf(stderr, "precompile: could not compile \"%s\"\n", sourcePath);
+		failed++;
+		return;
+	}
+
+	failed += Toy_writeFile(destPath, tb, size) != 0;
+	compiled++;
+
+	TOY_FREE_ARRAY(unsigned char, (unsigned char*)tb, size);
+}
+
+static void processFolder(const char* sourceFolder, const char* destFolder) {
+	DIR* dir = opendir(sourceFolder);
+
+	if (dir == NULL) {
+		fprintf(stderr, "precompile: could not open folder \"%s\"\n", sourceFolder);
+		failed++;
+		return;
+	}
+
+	mkdir(destFolder, 0755); //may already exist
+
+	struct dirent* ent;
+	while ((ent = readdir(dir)) != NULL) {
+		if (ent->d_name[0] == '.') {
+			continue;
+		}
+
+		char* sourcePath = joinPath(sourceFolder, ent->d_name);
+		char* destPath = joinPath(destFolder, ent->d_name);
+
+		struct stat pathStat;
+		if (stat(sourcePath, &pathStat) == 0) {
+			if (S_ISDIR(pathStat.st_mode)) {
+				processFolder(sourcePath, destPath);
+			}
+			else if (S_ISREG(pathStat.st_mode)) {
+				processFile(sourcePath, destPath, isScript(ent->d_name));
+			}
+		}
+
+		free(sourcePath);
+		free(destPath);
+	}
+
+	closedir(dir);
+}
+
+int main(int argc, char* argv[]) {
+	if (argc != 3) {
+		fprintf(stderr, "usage: precompile source_folder dest_folder\n");
+		return -1;
+	}
+
+	processFolder(argv[1], argv[2]);
+
+	printf("%s: %d scripts compiled, %d files copied, %d failed\n", argv[2], compiled, copied, failed);
+
+	return failed > 0 ? -1 : 0;
+}